@@ -0,0 +1,263 @@
+#include "AST.hpp"
+#include "Alphabet.hpp"
+#include "DFA.hpp"
+#include "NFA.hpp"
+#include "Parser.hpp"
+#include "Simplifier.hpp"
+
+#include <benchmark/benchmark.h>
+#include <regex/Regex.hpp>
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace regex
+{
+
+namespace
+{
+
+using automata::DFA;
+using automata::NFA;
+using ast::AST;
+using parser::Parser;
+
+using PatternFamily = std::string (*)(int64_t n);
+
+// (a|b)*a(a|b){n}: the minimal DFA has 2^(n+1) states
+std::string nthLetterFromEnd(int64_t n)
+{
+    return "(a|b)*a(a|b){" + std::to_string(n) + "}";
+}
+
+// x{n}: a linear chain of n states
+std::string countedRepetition(int64_t n)
+{
+    return "x{" + std::to_string(n) + "}";
+}
+
+// keyword0|keyword1|...: n literals sharing a common prefix
+std::string literalAlternation(int64_t n)
+{
+    std::string pattern;
+    for (int64_t i = 0; i < n; ++i)
+    {
+        pattern += (i == 0 ? "" : "|");
+        pattern += "keyword" + std::to_string(i);
+    }
+    return pattern;
+}
+
+// (a{1,n}b){1,n}: quantifiers nested two deep
+std::string nestedQuantifiers(int64_t n)
+{
+    const auto bound = std::to_string(n);
+    return "(a{1," + bound + "}b){1," + bound + "}";
+}
+
+// [Ā-āĄ-ą...]+: n disjoint Unicode ranges
+std::string unicodeClass(int64_t n)
+{
+    constexpr int64_t kFirst = 0x0100;
+    constexpr int64_t kStride = 4;
+
+    std::stringstream ss;
+    ss << "[" << std::hex << std::setfill('0');
+    for (int64_t i = 0; i < n; ++i)
+    {
+        const auto start = kFirst + i * kStride;
+        ss << "\\U" << std::setw(8) << start;
+        ss << "-";
+        ss << "\\U" << std::setw(8) << start + 1;
+    }
+    ss << "]+";
+    return ss.str();
+}
+
+// The AST the later phases start from, as built by Regex
+AST prepare(PatternFamily family, int64_t n)
+{
+    return ast::simplify(Parser(family(n)).parse());
+}
+
+void benchmarkParse(benchmark::State& state, PatternFamily family)
+{
+    const auto pattern = family(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Parser(pattern).parse());
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkSimplify(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = Parser(family(state.range(0))).parse();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ast::simplify(ast));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkAlphabet(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ast.makeAlphabet());
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkThompson(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+    const auto alphabet = ast.makeAlphabet();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ast.makeEpsilonNFA(alphabet));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkEpsilonRemoval(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+    const auto alphabet = ast.makeAlphabet();
+    const auto epsilonNFA = ast.makeEpsilonNFA(alphabet);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto nfa = epsilonNFA;
+        state.ResumeTiming();
+
+        nfa.removeEpsilonTransitions();
+        benchmark::DoNotOptimize(nfa);
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkGlushkov(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+    const auto alphabet = ast.makeAlphabet();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ast.makeNFA(alphabet));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkSubsetConstruction(benchmark::State& state,
+                                 PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+    const auto alphabet = ast.makeAlphabet();
+    const auto nfa = ast.makeNFA(alphabet);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(nfa.buildDFA());
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void benchmarkMinimization(benchmark::State& state, PatternFamily family)
+{
+    const auto ast = prepare(family, state.range(0));
+    const auto alphabet = ast.makeAlphabet();
+    const auto unminimized = ast.makeNFA(alphabet).buildDFA();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto dfa = unminimized;
+        state.ResumeTiming();
+
+        dfa.minimize();
+        benchmark::DoNotOptimize(dfa);
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+// Every phase at once, as run by the constructor of Regex
+void benchmarkRegex(benchmark::State& state, PatternFamily family)
+{
+    const auto pattern = family(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Regex(pattern));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void registerPhases(const std::string& name,
+                    PatternFamily family,
+                    const std::vector<int64_t>& sizes)
+{
+    using Phase = void (*)(benchmark::State&, PatternFamily);
+    const std::vector<std::pair<std::string, Phase>> phases = {
+        { "parse", benchmarkParse },
+        { "simplify", benchmarkSimplify },
+        { "alphabet", benchmarkAlphabet },
+        { "thompson", benchmarkThompson },
+        { "epsilon_removal", benchmarkEpsilonRemoval },
+        { "glushkov", benchmarkGlushkov },
+        { "subset_construction", benchmarkSubsetConstruction },
+        { "minimization", benchmarkMinimization },
+        { "regex", benchmarkRegex },
+    };
+
+    for (const auto& [phaseName, phase] : phases)
+    {
+        auto* benchmark = benchmark::RegisterBenchmark(
+          (name + "/" + phaseName).c_str(), phase, family);
+
+        for (const auto n : sizes)
+        {
+            benchmark->Arg(n);
+        }
+
+        benchmark->Complexity()->Unit(benchmark::kMicrosecond);
+    }
+}
+
+bool registerFamilies()
+{
+    registerPhases(
+      "nth_letter_from_end", nthLetterFromEnd, { 2, 4, 6, 8, 10 });
+    registerPhases("counted_repetition",
+                   countedRepetition,
+                   { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 });
+    registerPhases(
+      "literal_alternation", literalAlternation, { 8, 16, 32, 64, 128, 256 });
+    registerPhases("nested_quantifiers", nestedQuantifiers, { 2, 4, 8, 16 });
+    registerPhases("unicode_class",
+                   unicodeClass,
+                   { 64, 128, 256, 512, 1024, 2048, 4096 });
+    return true;
+}
+
+const bool kRegistered = registerFamilies();
+
+} // namespace
+} // namespace regex
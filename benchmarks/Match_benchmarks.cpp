@@ -0,0 +1,195 @@
+#include <benchmark/benchmark.h>
+#include <regex/Regex.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace regex
+{
+
+namespace
+{
+
+constexpr int64_t kMinInputSize = 16;
+constexpr int64_t kMaxInputSize = int64_t{ 64 } << 20;
+constexpr int kInputSizeMultiplier = 16;
+
+// Repeats unit until the target is size bytes long. The final repetition is
+// cut short on a code point boundary, so the target may be slightly shorter.
+std::string makeTarget(const std::string& unit, int64_t size)
+{
+    constexpr unsigned char kContinuationMask = 0xC0;
+    constexpr unsigned char kContinuationByte = 0x80;
+
+    std::string target;
+    target.reserve(static_cast<std::size_t>(size));
+
+    while (static_cast<int64_t>(target.size()) < size)
+    {
+        target += unit;
+    }
+
+    auto length = static_cast<std::size_t>(size);
+    while ((static_cast<unsigned char>(target[length]) & kContinuationMask) ==
+           kContinuationByte)
+    {
+        --length;
+    }
+    target.resize(length);
+
+    return target;
+}
+
+void benchmarkMatch(benchmark::State& state,
+                    const std::string& pattern,
+                    const std::string& unit,
+                    Mode mode)
+{
+    auto regex = Regex(pattern, mode);
+    const auto target = makeTarget(unit, state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(regex.match(target));
+    }
+
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(target.size()));
+}
+
+void benchmarkSearch(benchmark::State& state,
+                     const std::string& pattern,
+                     const std::string& unit,
+                     Mode mode)
+{
+    auto regex = Regex(pattern, mode);
+    const auto target = makeTarget(unit, state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(regex.search(target));
+    }
+
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(target.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  literal,
+                  "(GET /index.html HTTP/1.1\r\n)*",
+                  "GET /index.html HTTP/1.1\r\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  class_heavy,
+                  "[a-zA-Z0-9_ ,.;:!?'\"-]*",
+                  "The quick brown fox, jumps over the lazy dog! ",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  class_heavy_bytes,
+                  "[a-zA-Z0-9_ ,.;:!?'\"-]*",
+                  "The quick brown fox, jumps over the lazy dog! ",
+                  Mode::eBytes)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  alternation_heavy,
+                  "((GET|POST|PUT|DELETE|HEAD|OPTIONS|PATCH|TRACE) )*",
+                  "GET POST PUT DELETE HEAD OPTIONS PATCH TRACE ",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  unicode_heavy,
+                  "[\\u0400-\\u04FF\\u3040-\\u30FF\\U0001F600-\\U0001F64F ]*",
+                  "Привет こんにちは \U0001F600 ",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The DFA reaches its dead state on the first character
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  dead_state_early_exit,
+                  "a[0-9]*",
+                  "b0123456789",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The DFA reaches its accepting sink after the first three characters
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  accepting_sink_early_exit,
+                  "GET[\\x00-\\U0010ffff]*",
+                  "GET /index.html HTTP/1.1\r\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The line state is left only on a newline and skips ahead with memchr
+BENCHMARK_CAPTURE(benchmarkMatch,
+                  self_loop_acceleration,
+                  "(.*\n)*",
+                  "2024-01-01 12:00:00 INFO request served in 12ms by the "
+                  "upstream server at 10.0.0.1 after 3 retries\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The required literal never occurs, the prefilter rejects the target
+BENCHMARK_CAPTURE(benchmarkSearch,
+                  required_literal_absent,
+                  "user_id=[0-9]+ ERROR",
+                  "2024-01-01 12:00:00 INFO request served in 12ms\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The required literal occurs on every line but never matches, the automaton
+// runs only from a few characters before every occurrence
+BENCHMARK_CAPTURE(benchmarkSearch,
+                  required_literal_unmatched,
+                  "[0-9]{1,5} ERROR",
+                  "2024-01-01 12:00:00 WARN request served in 12ms, ERROR "
+                  "budget at 3%\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// The pattern is a plain literal and searched without an automaton
+BENCHMARK_CAPTURE(benchmarkSearch,
+                  literal_only_absent,
+                  "connection refused",
+                  "2024-01-01 12:00:00 INFO request served in 12ms\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// None of the literals of the alternation occurs, the prefilter rejects the
+// target looking for all of them at once
+BENCHMARK_CAPTURE(benchmarkSearch,
+                  literal_set_absent,
+                  "(FATAL|PANIC|ERROR|CRITICAL): [a-z]+",
+                  "2024-01-01 12:00:00 INFO request served in 12ms\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+// Without a required literal the whole target runs through the automaton
+BENCHMARK_CAPTURE(benchmarkSearch,
+                  no_literal,
+                  "[A-Z]{5}[0-9]",
+                  "2024-01-01 12:00:00 INFO request served in 12ms\n",
+                  Mode::eUtf8)
+  ->RangeMultiplier(kInputSizeMultiplier)
+  ->Range(kMinInputSize, kMaxInputSize);
+
+} // namespace regex
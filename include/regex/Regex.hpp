@@ -1,11 +1,30 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace regex
 {
 
+/**
+ * @brief Selects how the pattern and the targets are interpreted.
+ */
+enum class Mode
+{
+    /**
+     * Pattern and targets contain utf-8 encoded character code points.
+     */
+    eUtf8,
+
+    /**
+     * Pattern and targets contain raw bytes (latin-1 or binary data).
+     * The alphabet is limited to the values 0-255.
+     */
+    eBytes
+};
+
 /**
  * @brief Regex class used for matching a target against a pattern.
  */
@@ -16,9 +35,12 @@ public:
      * @brief Create a new Regex object.
      * @param pattern
      *        The patter to match against.
-     *        This string shall contain utf-8 encoded character code points.
+     *        This string shall contain utf-8 encoded character code points,
+     *        or raw bytes when mode is Mode::eBytes.
+     * @param mode
+     *        The interpretation of the pattern and of the targets.
      */
-    explicit Regex(const std::string& pattern);
+    explicit Regex(const std::string& pattern, Mode mode = Mode::eUtf8);
 
     /**
      * @brief Deleted copy construction.
@@ -49,11 +71,93 @@ public:
      * @brief Matches a target against the regex.
      * @param target
      *        The string to match.
-     *        This string shall contain utf-8 encoded character code points.
+     *        This string shall contain utf-8 encoded character code points,
+     *        or raw bytes when the regex was created with Mode::eBytes.
      * @return True if the COMPLETE target matches the regex, otherwise false.
      */
     bool match(const std::string& target);
 
+    /**
+     * @brief Matches a target against the regex.
+     * @param target
+     *        The string to match.
+     *        This string shall contain utf-16 encoded character code points.
+     *        Unpaired surrogates are read as code points of their own.
+     *        Code points above 0xFF never match a regex created with
+     *        Mode::eBytes.
+     * @return True if the COMPLETE target matches the regex, otherwise false.
+     */
+    bool match(const std::u16string& target);
+
+    /**
+     * @brief Matches a target against the regex.
+     * @param target
+     *        The string to match.
+     *        This string shall contain utf-32 encoded character code points.
+     *        Code points above 0xFF never match a regex created with
+     *        Mode::eBytes.
+     * @return True if the COMPLETE target matches the regex, otherwise false.
+     */
+    bool match(const std::u32string& target);
+
+    /**
+     * @brief Searches the target for a part matching the regex.
+     * @param target
+     *        The string to search.
+     *        This string shall contain utf-8 encoded character code points,
+     *        or raw bytes when the regex was created with Mode::eBytes.
+     * @return True if ANY part of the target matches the regex, otherwise
+     *         false.
+     */
+    bool search(const std::string& target);
+
+    /**
+     * @brief Searches the target for a part matching the regex.
+     * @param target
+     *        The string to search.
+     *        This string shall contain utf-16 encoded character code points.
+     *        Unpaired surrogates are read as code points of their own.
+     *        Targets with code points above 0xFF are never found by a regex
+     *        created with Mode::eBytes.
+     * @return True if ANY part of the target matches the regex, otherwise
+     *         false.
+     */
+    bool search(const std::u16string& target);
+
+    /**
+     * @brief Searches the target for a part matching the regex.
+     * @param target
+     *        The string to search.
+     *        This string shall contain utf-32 encoded character code points.
+     *        Targets with code points above 0xFF are never found by a regex
+     *        created with Mode::eBytes.
+     * @return True if ANY part of the target matches the regex, otherwise
+     *         false.
+     */
+    bool search(const std::u32string& target);
+
+    /**
+     * @brief Counts how often every state of the automaton used by match()
+     *        is visited when matching the samples.
+     * @param samples
+     *        Targets representative of those matched later.
+     *        These strings shall be encoded like targets of match().
+     * @return The visit count of every state, indexed by state. States that
+     *         are never left once entered come first.
+     */
+    std::vector<std::size_t> profile(const std::vector<std::string>& samples);
+
+    /**
+     * @brief Renumbers the states of the automaton used by match() by how
+     *        often they are visited when matching the samples. The most
+     *        visited states are stored next to each other, so they share
+     *        cache lines. The result of match() does not change.
+     * @param samples
+     *        Targets representative of those matched later.
+     *        These strings shall be encoded like targets of match().
+     */
+    void optimize(const std::vector<std::string>& samples);
+
 private:
     /**
      * PIMPL.
@@ -1 +0,0 @@
-#include "Bimap.hpp"
\ No newline at end of file
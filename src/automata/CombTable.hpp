@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Automata.hpp"
+#include "DFA.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace automata
+{
+
+// A minimized DFA compressed by row displacement (a "comb"). Every state
+// keeps its most frequent destination as default. The remaining transitions
+// of all states are interleaved into one array: those of a state are stored
+// at its base plus the input and tagged with the state as owner. A step is
+// still O(1) but the table only grows with the number of transitions that
+// differ from the defaults. Id is the type of the state ids, Class the one
+// of the inputs.
+template<typename Id, typename Class>
+class CombTable
+{
+public:
+    using InputClass = Class;
+
+    // Whether the state ids of the DFA fit into Id. The largest value marks
+    // unused slots.
+    [[nodiscard]] static bool fits(const DFA& dfa)
+    {
+        return dfa.stateCount() < std::numeric_limits<Id>::max();
+    }
+
+    // The accelerated states are numbered right after the sinks
+    explicit CombTable(const DFA& dfa, std::size_t acceleratedCount = 0);
+
+    [[nodiscard]] Id start() const
+    {
+        return mStart;
+    }
+
+    [[nodiscard]] Id step(Id state, Class input) const
+    {
+        const auto slot = mBase[state] + static_cast<std::size_t>(input);
+        return mOwner[slot] == state ? mNext[slot] : mDefault[state];
+    }
+
+    // Whether the state is never left, one compare as the sinks come first
+    [[nodiscard]] bool isSink(Id state) const
+    {
+        return state < mSinkCount;
+    }
+
+    // Whether the state is a sink or accelerated, one compare as both come
+    // first
+    [[nodiscard]] bool isSpecial(Id state) const
+    {
+        return state < mSpecialEnd;
+    }
+
+    [[nodiscard]] bool isFinal(Id state) const
+    {
+        return mFinal[state] != 0;
+    }
+
+    // The id of the state in the DFA
+    [[nodiscard]] std::size_t index(Id state) const
+    {
+        return state;
+    }
+
+    [[nodiscard]] std::size_t bytes() const
+    {
+        const auto ids = mDefault.size() + mNext.size() + mOwner.size();
+        return mBase.size() * sizeof(std::size_t) + ids * sizeof(Id) +
+               mFinal.size();
+    }
+
+private:
+    static constexpr Id kUnused = std::numeric_limits<Id>::max();
+    static constexpr unsigned int kMaxProbes = 64;
+
+    Id mStart;
+    Id mSinkCount;
+    Id mSpecialEnd;
+    std::vector<std::size_t> mBase;
+    std::vector<Id> mDefault;
+    std::vector<uint8_t> mFinal;
+    std::vector<Id> mNext;
+    std::vector<Id> mOwner;
+};
+
+template<typename Id, typename Class>
+CombTable<Id, Class>::CombTable(const DFA& dfa, std::size_t acceleratedCount)
+  : mStart{ static_cast<Id>(dfa.getStartState()) }
+  , mSinkCount{ static_cast<Id>(dfa.sinkCount()) }
+  , mSpecialEnd{ static_cast<Id>(dfa.sinkCount() + acceleratedCount) }
+  , mBase(dfa.stateCount(), 0)
+  , mDefault(dfa.stateCount())
+  , mFinal(dfa.stateCount())
+{
+    const auto stateCount = dfa.stateCount();
+    const auto inputCount = dfa.inputCount();
+
+    // The inputs of every state that do not lead to its default
+    std::vector<std::vector<InputType>> exceptions(stateCount);
+    std::vector<std::size_t> frequency(stateCount, 0);
+
+    for (StateId state = 0; state < stateCount; ++state)
+    {
+        StateId mostFrequent = 0;
+        for (std::size_t input = 0; input < inputCount; ++input)
+        {
+            const auto destination =
+              dfa.step(state, static_cast<InputType>(input));
+            if (++frequency[destination] > frequency[mostFrequent])
+            {
+                mostFrequent = destination;
+            }
+        }
+        mDefault[state] = static_cast<Id>(mostFrequent);
+
+        for (std::size_t input = 0; input < inputCount; ++input)
+        {
+            const auto destination =
+              dfa.step(state, static_cast<InputType>(input));
+            frequency[destination] = 0;
+
+            if (destination != mDefault[state])
+            {
+                exceptions[state].push_back(static_cast<InputType>(input));
+            }
+        }
+
+        mFinal[state] = dfa.isFinalState(state) ? 1 : 0;
+    }
+
+    // Place the fullest rows first, each at the lowest base where all of its
+    // exceptions hit unused slots. The search gives up after a few bases and
+    // appends the row instead, which bounds the packing time. Rows without
+    // exceptions stay at base 0, every slot they may look at is owned by
+    // another state.
+    std::vector<StateId> order(stateCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+      order.begin(),
+      order.end(),
+      [&exceptions](StateId lhs, StateId rhs)
+      { return exceptions[lhs].size() > exceptions[rhs].size(); });
+
+    mOwner.assign(inputCount, kUnused);
+    std::size_t firstUnused = 0;
+
+    for (const auto state : order)
+    {
+        const auto& inputs = exceptions[state];
+        if (inputs.empty())
+        {
+            break;
+        }
+
+        const auto isFree = [this, &inputs](std::size_t base)
+        {
+            return std::all_of(
+              inputs.begin(),
+              inputs.end(),
+              [this, base](InputType input)
+              {
+                  const auto slot = base + static_cast<std::size_t>(input);
+                  return slot >= mOwner.size() || mOwner[slot] == kUnused;
+              });
+        };
+
+        const auto front = static_cast<std::size_t>(inputs.front());
+        auto base = firstUnused > front ? firstUnused - front : 0;
+        for (auto probes = 0U; !isFree(base); ++probes)
+        {
+            base = probes < kMaxProbes ? base + 1 : mOwner.size() - front;
+        }
+
+        // Every base in use stays followed by a full row of slots
+        mOwner.resize(std::max(mOwner.size(), base + inputCount), kUnused);
+        mNext.resize(mOwner.size(), 0);
+        mBase[state] = base;
+
+        for (const auto input : inputs)
+        {
+            const auto slot = base + static_cast<std::size_t>(input);
+            mOwner[slot] = static_cast<Id>(state);
+            mNext[slot] = static_cast<Id>(dfa.step(state, input));
+        }
+
+        while (firstUnused < mOwner.size() && mOwner[firstUnused] != kUnused)
+        {
+            ++firstUnused;
+        }
+    }
+
+    mNext.resize(mOwner.size(), 0);
+}
+
+} // namespace automata
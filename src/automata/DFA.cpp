@@ -2,27 +2,27 @@
 
 #include <algorithm>
 #include <cassert>
-#include <optional>
-#include <unordered_set>
+#include <map>
+#include <numeric>
+#include <utility>
 
 namespace automata
 {
 
-DFAState::DFAState(StateId id, bool isStart, bool isFinal)
+DFAState::DFAState(StateId id,
+                   bool isStart,
+                   bool isFinal,
+                   std::size_t alphabetSize)
   : Id{ id }
   , IsStart{ isStart }
   , IsFinal{ isFinal }
+  , Transitions(alphabetSize, id)
 {
 }
 
 void DFAState::addTransition(InputType input, StateId destination)
 {
-    Transitions[input] = destination;
-
-    if (destination != Id)
-    {
-        IsDead = false;
-    }
+    Transitions.at(static_cast<std::size_t>(input)) = destination;
 }
 
 DFA::DFA(Alphabet alphabet)
@@ -42,7 +42,7 @@ StateId DFA::addState(bool isStart, bool isFinal)
         mFinalStates.emplace_back(mStateCount);
     }
 
-    mStates.emplace_back(mStateCount, isStart, isFinal);
+    mStates.emplace_back(mStateCount, isStart, isFinal, mAlphabet.size());
 
     return mStateCount++;
 }
@@ -59,201 +59,515 @@ StateId DFA::getStartState() const
 
 StateId DFA::step(StateId current, InputType input) const
 {
-    const auto next = mStates.at(current).Transitions.at(input);
+    const auto next =
+      mStates.at(current).Transitions.at(static_cast<std::size_t>(input));
     return mStates.at(next).Id;
 }
 
-bool DFA::isDeadState(StateId current) const
+bool DFA::isFinalState(StateId current) const
 {
-    return mStates.at(current).IsDead;
+    return mStates.at(current).IsFinal;
 }
 
-bool DFA::isFinalState(StateId current) const
+std::size_t DFA::stateCount() const
 {
-    return mStates.at(current).IsFinal;
+    return mStates.size();
 }
 
-struct Partition
+std::size_t DFA::inputCount() const
 {
-    Partition(PartitionId id)
-      : Id{ id }
-    {
-    }
+    return mAlphabet.size();
+}
 
-    void insert(StateId state)
-    {
-        if (!LeaderSelected)
-        {
-            Leader = state;
-            LeaderSelected = true;
-        }
+StateId DFA::sinkCount() const
+{
+    return mSinkCount;
+}
 
-        States.insert(state);
-    }
+namespace
+{
 
-    std::unordered_set<StateId> States;
-    bool LeaderSelected{ false };
-    StateId Leader{};
-    const PartitionId Id;
-};
+using BlockId = unsigned int;
 
-struct PartitionPool
+// A partition of the states 0..N-1 into blocks that can be refined in place.
+// The states of a block are stored contiguously in Elements. Marking a state
+// moves it to the front of its block so that splitting a block only has to
+// move the boundary between the marked and the unmarked states.
+struct Partition
 {
-    PartitionPool() = default;
+    explicit Partition(std::size_t stateCount);
 
-    PartitionId addPartition();
+    void mark(StateId state);
 
-    [[nodiscard]] ParitionMap makePartitionMap() const;
+    // Splits every touched block into its marked and unmarked states.
+    // Calls onSplit(oldBlock, newBlock) where newBlock holds the marked states.
+    template<typename OnSplit>
+    void split(OnSplit onSplit);
 
-    void addState(PartitionId partition, StateId state);
+    [[nodiscard]] std::size_t size(BlockId block) const
+    {
+        return End[block] - Start[block];
+    }
+
+    [[nodiscard]] std::size_t blockCount() const { return Start.size(); }
 
-    std::vector<Partition> Partitions;
+    std::vector<StateId> Elements;
+    std::vector<std::size_t> Location;
+    std::vector<BlockId> BlockOf;
 
-    unsigned int PartitionCount{};
+    std::vector<std::size_t> Start;
+    std::vector<std::size_t> End;
+    std::vector<std::size_t> Marked;
+    std::vector<BlockId> Touched;
 };
 
-PartitionId PartitionPool::addPartition()
+Partition::Partition(std::size_t stateCount)
+  : Elements(stateCount)
+  , Location(stateCount)
+  , BlockOf(stateCount, 0)
+  , Start{ 0 }
+  , End{ stateCount }
+  , Marked{ 0 }
 {
-    Partitions.emplace_back(PartitionCount);
-    return PartitionCount++;
+    for (std::size_t i = 0; i < stateCount; ++i)
+    {
+        Elements[i] = static_cast<StateId>(i);
+        Location[i] = i;
+    }
 }
 
-ParitionMap PartitionPool::makePartitionMap() const
+void Partition::mark(StateId state)
 {
-    ParitionMap map;
+    const auto block = BlockOf[state];
+    const auto boundary = Start[block] + Marked[block];
+    const auto location = Location[state];
 
-    for (const auto& parition : Partitions)
+    if (location < boundary)
     {
-        for (const auto state : parition.States)
+        // already marked
+        return;
+    }
+
+    if (Marked[block] == 0)
+    {
+        Touched.push_back(block);
+    }
+
+    const auto other = Elements[boundary];
+    std::swap(Elements[location], Elements[boundary]);
+    Location[state] = boundary;
+    Location[other] = location;
+    ++Marked[block];
+}
+
+template<typename OnSplit>
+void Partition::split(OnSplit onSplit)
+{
+    for (const auto block : Touched)
+    {
+        const auto marked = Marked[block];
+        Marked[block] = 0;
+
+        if (marked == size(block))
+        {
+            // every state was marked, nothing to split
+            continue;
+        }
+
+        const auto newBlock = static_cast<BlockId>(blockCount());
+        Start.push_back(Start[block]);
+        End.push_back(Start[block] + marked);
+        Marked.push_back(0);
+        Start[block] += marked;
+
+        for (auto i = Start[newBlock]; i < End[newBlock]; ++i)
         {
-            map[state] = parition.Id;
+            BlockOf[Elements[i]] = newBlock;
         }
+
+        onSplit(block, newBlock);
     }
 
-    return map;
+    Touched.clear();
 }
 
+} // namespace
+
 void DFA::minimize()
 {
-    // Using the partitioning method of DFA minimization
+    // Hopcroft's partition refinement algorithm in O(n * k * log(n))
+
+    const auto stateCount = mStates.size();
+    const auto inputCount = mAlphabet.size();
 
-    // STEP1: parition the original dfa
+    const auto transition = [this](std::size_t state, std::size_t input)
+    { return mStates[state].Transitions[input]; };
 
-    PartitionPool pool;
-    ParitionMap prevPartitionMap;
-    ParitionMap currPartitionMap;
+    // STEP1: index the inverse transitions. The sources of all transitions
+    // into a destination on an input are stored contiguously.
 
-    auto partitionFinal = std::optional<PartitionId>();
-    auto partitionNonFinal = std::optional<PartitionId>();
+    const auto inverseIndex = [stateCount](std::size_t input, StateId dest)
+    { return input * stateCount + dest; };
 
-    for (const auto& state : mStates)
+    std::vector<std::size_t> inverseOffsets(inputCount * stateCount + 1, 0);
+    for (std::size_t state = 0; state < stateCount; ++state)
     {
-        if (!state.IsFinal)
+        for (std::size_t input = 0; input < inputCount; ++input)
         {
-            if (!partitionNonFinal.has_value())
-            {
-                partitionNonFinal = pool.addPartition();
-            }
-            pool.Partitions[partitionNonFinal.value()].insert(state.Id);
+            ++inverseOffsets[inverseIndex(input, transition(state, input)) + 1];
         }
-        else
+    }
+
+    for (std::size_t i = 1; i < inverseOffsets.size(); ++i)
+    {
+        inverseOffsets[i] += inverseOffsets[i - 1];
+    }
+
+    std::vector<StateId> inverseSources(inverseOffsets.back());
+    auto cursors = inverseOffsets;
+    for (std::size_t state = 0; state < stateCount; ++state)
+    {
+        for (std::size_t input = 0; input < inputCount; ++input)
         {
-            if (!partitionFinal.has_value())
-            {
-                partitionFinal = pool.addPartition();
-            }
-            pool.Partitions[partitionFinal.value()].insert(state.Id);
+            const auto index = inverseIndex(input, transition(state, input));
+            inverseSources[cursors[index]++] = static_cast<StateId>(state);
         }
     }
 
-    currPartitionMap = pool.makePartitionMap();
+    // STEP2: start with the final and the non-final states
+
+    Partition partition(stateCount);
+    std::vector<std::pair<BlockId, std::size_t>> worklist;
+    std::vector<bool> inWorklist;
+
+    const auto addSplitter = [&](BlockId block, std::size_t input)
+    {
+        worklist.emplace_back(block, input);
+        inWorklist[block * inputCount + input] = true;
+    };
+
+    for (const auto state : mFinalStates)
+    {
+        partition.mark(state);
+    }
 
-    while (currPartitionMap != prevPartitionMap)
+    partition.split(
+      [&](BlockId block, BlockId newBlock)
+      {
+          // Either half may be the splitter. The smaller half is cheaper.
+          inWorklist.resize(partition.blockCount() * inputCount, false);
+          const auto smaller =
+            partition.size(newBlock) < partition.size(block) ? newBlock
+                                                             : block;
+          for (std::size_t input = 0; input < inputCount; ++input)
+          {
+              addSplitter(smaller, input);
+          }
+      });
+
+    // STEP3: split blocks until no splitter separates any states
+
+    std::vector<StateId> predecessors;
+    while (!worklist.empty())
     {
-        auto paritionId = PartitionId{ 0 };
-        std::vector<StateId> movedStates{};
+        const auto [splitter, input] = worklist.back();
+        worklist.pop_back();
+        inWorklist[splitter * inputCount + input] = false;
+
+        // Collect first. Marking reorders the states of the splitter itself.
+        predecessors.clear();
+        for (auto i = partition.Start[splitter]; i < partition.End[splitter];
+             ++i)
+        {
+            const auto index = inverseIndex(input, partition.Elements[i]);
+            predecessors.insert(
+              predecessors.end(),
+              inverseSources.begin() +
+                static_cast<std::ptrdiff_t>(inverseOffsets[index]),
+              inverseSources.begin() +
+                static_cast<std::ptrdiff_t>(inverseOffsets[index + 1]));
+        }
 
-        while (paritionId < pool.Partitions.size())
+        for (const auto predecessor : predecessors)
         {
-            movedStates.clear();
+            partition.mark(predecessor);
+        }
+
+        partition.split(
+          [&](BlockId block, BlockId newBlock)
+          {
+              inWorklist.resize(partition.blockCount() * inputCount, false);
+              const auto smaller =
+                partition.size(newBlock) < partition.size(block) ? newBlock
+                                                                 : block;
+              for (std::size_t other = 0; other < inputCount; ++other)
+              {
+                  if (inWorklist[block * inputCount + other])
+                  {
+                      addSplitter(newBlock, other);
+                  }
+                  else
+                  {
+                      addSplitter(smaller, other);
+                  }
+              }
+          });
+    }
+
+    // STEP4: create new DFA from the blocks. New states are numbered in
+    // order of their first member so that the start state keeps its place.
+
+    DFA newDFA(mAlphabet);
+
+    const auto startBlock = partition.BlockOf[mStartState];
+    std::vector<StateId> newStates(partition.blockCount(), 0);
+    std::vector<bool> created(partition.blockCount(), false);
+    std::vector<StateId> representatives;
 
-            for (const auto state : pool.Partitions[paritionId].States)
+    for (std::size_t state = 0; state < stateCount; ++state)
+    {
+        const auto block = partition.BlockOf[state];
+        if (!created[block])
+        {
+            created[block] = true;
+            newStates[block] = newDFA.addState(block == startBlock,
+                                               mStates[state].IsFinal);
+            representatives.push_back(static_cast<StateId>(state));
+        }
+    }
+
+    for (std::size_t newState = 0; newState < representatives.size();
+         ++newState)
+    {
+        const auto representative = representatives[newState];
+        for (const auto c : mAlphabet)
+        {
+            const auto target = transition(representative,
+                                           static_cast<std::size_t>(c));
+            newDFA.addTransition(c,
+                                 static_cast<StateId>(newState),
+                                 newStates[partition.BlockOf[target]]);
+        }
+    }
+
+    // STEP5: replace old DFA with new DFA
+    *this = std::move(newDFA);
+}
+
+void DFA::trim()
+{
+    const auto stateCount = mStates.size();
+
+    // STEP1: find the states reachable from the start state
+
+    std::vector<bool> reachable(stateCount, false);
+    std::vector<StateId> stack{ mStartState };
+    reachable[mStartState] = true;
+
+    std::vector<std::vector<StateId>> predecessors(stateCount);
+    while (!stack.empty())
+    {
+        const auto state = stack.back();
+        stack.pop_back();
+
+        for (const auto destination : mStates[state].Transitions)
+        {
+            predecessors[destination].push_back(state);
+            if (!reachable[destination])
             {
-                if (state != pool.Partitions[paritionId].Leader)
-                {
-                    if (!checkEquivalence(currPartitionMap,
-                                          pool.Partitions[paritionId].Leader,
-                                          state))
-                    {
-                        movedStates.emplace_back(state);
-                    }
-                }
+                reachable[destination] = true;
+                stack.push_back(destination);
             }
+        }
+    }
 
-            if (!movedStates.empty())
-            {
-                const auto newPartition = pool.addPartition();
+    // STEP2: find the states from which a final state is reachable
+
+    std::vector<bool> coreachable(stateCount, false);
+    for (const auto state : mFinalStates)
+    {
+        if (reachable[state])
+        {
+            coreachable[state] = true;
+            stack.push_back(state);
+        }
+    }
+
+    while (!stack.empty())
+    {
+        const auto state = stack.back();
+        stack.pop_back();
 
-                for (const auto state : movedStates)
-                {
-                    pool.Partitions[paritionId].States.erase(state);
-                    pool.Partitions[newPartition].insert(state);
-                }
+        for (const auto predecessor : predecessors[state])
+        {
+            if (!coreachable[predecessor])
+            {
+                coreachable[predecessor] = true;
+                stack.push_back(predecessor);
             }
+        }
+    }
+
+    // STEP3: number the dead state first, then the accepting sinks, then
+    // the remaining states in their current order
 
-            paritionId++;
+    const auto isKept = [&](std::size_t state)
+    { return reachable[state] && coreachable[state]; };
+
+    const auto isAcceptingSink = [this](std::size_t state)
+    {
+        const auto& transitions = mStates[state].Transitions;
+        return mStates[state].IsFinal &&
+               std::all_of(transitions.begin(),
+                           transitions.end(),
+                           [state](StateId destination)
+                           { return destination == state; });
+    };
+
+    std::vector<StateId> order;
+    for (std::size_t state = 0; state < stateCount; ++state)
+    {
+        if (isKept(state) && isAcceptingSink(state))
+        {
+            order.push_back(static_cast<StateId>(state));
+        }
+    }
+
+    const auto sinkCount = order.size();
+    for (std::size_t state = 0; state < stateCount; ++state)
+    {
+        if (isKept(state) && !isAcceptingSink(state))
+        {
+            order.push_back(static_cast<StateId>(state));
         }
+    }
+
+    // The reachable states that are not kept merge into the dead state
+    const auto reachableCount = static_cast<std::size_t>(
+      std::count(reachable.begin(), reachable.end(), true));
+    const auto hasDeadState = order.size() < reachableCount;
 
-        std::swap(prevPartitionMap, currPartitionMap);
-        currPartitionMap = pool.makePartitionMap();
+    const auto offset = hasDeadState ? StateId{ 1 } : StateId{ 0 };
+    std::vector<StateId> newStates(stateCount, 0);
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        newStates[order[i]] = static_cast<StateId>(i) + offset;
     }
 
-    // STEP2: create new DFA from partitions
+    // STEP4: create new DFA in the new order. The dead state loops on every
+    // input, as every new state does until its transitions are added.
 
     DFA newDFA(mAlphabet);
 
-    for (const auto& partition : pool.Partitions)
+    if (hasDeadState)
+    {
+        newDFA.addState(!isKept(mStartState), false);
+    }
+
+    for (const auto state : order)
     {
-        bool isStart = false;
-        bool isFinal = false;
+        newDFA.addState(state == mStartState, mStates[state].IsFinal);
+    }
 
-        for (const auto state : pool.Partitions[partition.Id].States)
+    for (const auto state : order)
+    {
+        for (const auto c : mAlphabet)
         {
-            isStart |= mStates.at(state).IsStart;
-            isFinal |= mStates.at(state).IsFinal;
+            const auto destination =
+              mStates[state].Transitions[static_cast<std::size_t>(c)];
+            newDFA.addTransition(c, newStates[state], newStates[destination]);
         }
+    }
+
+    newDFA.mSinkCount = static_cast<StateId>(sinkCount) + offset;
+
+    // STEP5: replace old DFA with new DFA
+    *this = std::move(newDFA);
+}
+
+void DFA::reorder(const std::vector<std::size_t>& ranks)
+{
+    const auto stateCount = mStates.size();
+
+    std::vector<StateId> order(stateCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin() + mSinkCount,
+                     order.end(),
+                     [&ranks](StateId lhs, StateId rhs)
+                     { return ranks[lhs] > ranks[rhs]; });
+
+    std::vector<StateId> newStates(stateCount);
+    for (std::size_t i = 0; i < stateCount; ++i)
+    {
+        newStates[order[i]] = static_cast<StateId>(i);
+    }
+
+    DFA newDFA(mAlphabet);
 
-        const auto newState = newDFA.addState(isStart, isFinal);
+    for (const auto state : order)
+    {
+        newDFA.addState(state == mStartState, mStates[state].IsFinal);
+    }
 
+    for (const auto state : order)
+    {
         for (const auto c : mAlphabet)
         {
-            const auto targetState = currPartitionMap.at(
-              mStates.at(partition.Leader).Transitions.at(c));
-            newDFA.addTransition(c, newState, targetState);
+            const auto destination =
+              mStates[state].Transitions[static_cast<std::size_t>(c)];
+            newDFA.addTransition(c, newStates[state], newStates[destination]);
         }
     }
 
-    // STEP3: replace old DFA with new DFA
+    newDFA.mSinkCount = mSinkCount;
     *this = std::move(newDFA);
 }
 
-bool DFA::checkEquivalence(const ParitionMap& paritionMap,
-                           StateId stateA,
-                           StateId stateB) const
+std::vector<InputType> DFA::mergeInputs()
 {
-    auto equiv = [&](InputType c)
+    // Two inputs are indistinguishable when their columns of the transition
+    // table are equal
+    std::map<std::vector<StateId>, InputType> columns;
+    std::vector<InputType> newInputs;
+    std::vector<std::size_t> representatives;
+
+    std::vector<StateId> column(mStates.size());
+    for (std::size_t input = 0; input < mAlphabet.size(); ++input)
     {
-        const auto stateADest = mStates.at(stateA).Transitions.at(c);
-        const auto stateBDest = mStates.at(stateB).Transitions.at(c);
+        for (std::size_t state = 0; state < mStates.size(); ++state)
+        {
+            column[state] = mStates[state].Transitions[input];
+        }
 
-        if (stateADest == stateBDest)
+        const auto newInput = static_cast<InputType>(columns.size());
+        const auto [it, inserted] = columns.emplace(column, newInput);
+        if (inserted)
         {
-            return true;
+            representatives.push_back(input);
         }
-        return paritionMap.at(stateADest) == paritionMap.at(stateBDest);
-    };
+        newInputs.push_back(it->second);
+    }
+
+    if (representatives.size() == mAlphabet.size())
+    {
+        return newInputs;
+    }
+
+    for (auto& state : mStates)
+    {
+        std::vector<StateId> transitions;
+        transitions.reserve(representatives.size());
+        for (const auto input : representatives)
+        {
+            transitions.push_back(state.Transitions[input]);
+        }
+        state.Transitions = std::move(transitions);
+    }
+
+    mAlphabet.resize(representatives.size());
+    std::iota(mAlphabet.begin(), mAlphabet.end(), 0);
 
-    return std::all_of(mAlphabet.cbegin(), mAlphabet.cend(), equiv);
+    return newInputs;
 }
 
-} // namespace automata
\ No newline at end of file
+} // namespace automata
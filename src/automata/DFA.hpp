@@ -3,29 +3,25 @@
 
 #include "Automata.hpp"
 
-#include <map>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace automata
 {
 
-using PartitionId = unsigned int;
-using ParitionMap = std::unordered_map<StateId, PartitionId>;
-
 class DFAState
 {
 public:
-    DFAState(StateId id, bool isStart, bool isFinal);
+    DFAState(StateId id, bool isStart, bool isFinal, std::size_t alphabetSize);
 
     void addTransition(InputType input, StateId destination);
 
     const StateId Id;
     const bool IsStart;
     const bool IsFinal;
-    bool IsDead{ true };
-    std::map<InputType, StateId> Transitions;
+
+    // Indexed by input. Inputs are the indices 0..N-1 of the alphabet.
+    std::vector<StateId> Transitions;
 };
 
 class DFA
@@ -39,21 +35,38 @@ public:
 
     [[nodiscard]] StateId step(StateId current, InputType input) const;
     [[nodiscard]] StateId getStartState() const;
-    [[nodiscard]] bool isDeadState(StateId current) const;
     [[nodiscard]] bool isFinalState(StateId current) const;
+    [[nodiscard]] std::size_t stateCount() const;
+    [[nodiscard]] std::size_t inputCount() const;
+
+    // The states below the sink count are never left once entered. They are
+    // the dead state followed by the accepting sinks. Valid after trim().
+    [[nodiscard]] StateId sinkCount() const;
 
     void minimize();
 
+    // Removes the states unreachable from the start state and merges the
+    // states that cannot reach a final state into one dead state. The sinks
+    // are renumbered to come first.
+    void trim();
+
+    // Renumbers the states that are not sinks by descending rank, e.g. their
+    // visit counts so that the most visited states are stored next to each
+    // other. States of equal rank keep their order. Ranks is indexed by state.
+    void reorder(const std::vector<std::size_t>& ranks);
+
+    // Merges the inputs on which every state moves to the same destination.
+    // The merged inputs are numbered in order of their first member. Returns
+    // the new input of every old input.
+    std::vector<InputType> mergeInputs();
+
 private:
     std::vector<DFAState> mStates;
     unsigned int mStateCount{ 0 };
     StateId mStartState{};
     std::vector<StateId> mFinalStates;
+    StateId mSinkCount{ 0 };
     Alphabet mAlphabet;
-
-    [[nodiscard]] bool checkEquivalence(const ParitionMap& paritionMap,
-                                        StateId stateA,
-                                        StateId stateB) const;
 };
 
 } // namespace automata
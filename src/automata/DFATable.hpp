@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Automata.hpp"
+#include "DFA.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace automata
+{
+
+// A minimized DFA laid out for matching. Every state is a row of one flat
+// table holding the destination of every input followed by the flags of the
+// state. States are referred to by the offset of their row rather than by
+// their id, so stepping is a single load without a multiplication. Offset is
+// the narrowest unsigned type holding the offset of every row, Class the
+// narrowest one holding every input.
+template<typename Offset, typename Class>
+class DFATable
+{
+public:
+    using InputClass = Class;
+
+    // Whether the offsets of the rows of the DFA fit into Offset
+    [[nodiscard]] static bool fits(const DFA& dfa)
+    {
+        const auto stride = dfa.inputCount() + 1;
+        return dfa.stateCount() * stride - 1 <=
+               std::numeric_limits<Offset>::max();
+    }
+
+    // The size of the table of the DFA
+    [[nodiscard]] static std::size_t bytes(const DFA& dfa)
+    {
+        return dfa.stateCount() * (dfa.inputCount() + 1) * sizeof(Offset);
+    }
+
+    // The accelerated states are numbered right after the sinks
+    explicit DFATable(const DFA& dfa, std::size_t acceleratedCount = 0);
+
+    [[nodiscard]] Offset start() const
+    {
+        return mStart;
+    }
+
+    [[nodiscard]] Offset step(Offset state, Class input) const
+    {
+        return mCells[state + static_cast<std::size_t>(input)];
+    }
+
+    // Whether the state is never left, one compare as the sinks come first
+    [[nodiscard]] bool isSink(Offset state) const
+    {
+        return state < mSinkEnd;
+    }
+
+    // Whether the state is a sink or accelerated, one compare as both come
+    // first. Lets the executor keep a single branch for either.
+    [[nodiscard]] bool isSpecial(Offset state) const
+    {
+        return state < mSpecialEnd;
+    }
+
+    [[nodiscard]] bool isFinal(Offset state) const
+    {
+        return (mCells[state + mFlags] & kFinal) != 0;
+    }
+
+    // The id of the state in the DFA
+    [[nodiscard]] std::size_t index(Offset state) const
+    {
+        return state / (mFlags + 1);
+    }
+
+private:
+    static constexpr Offset kFinal = 1;
+
+    // The index of the flags within a row
+    std::size_t mFlags;
+    Offset mStart;
+    Offset mSinkEnd;
+    Offset mSpecialEnd;
+    std::vector<Offset> mCells;
+};
+
+template<typename Offset, typename Class>
+DFATable<Offset, Class>::DFATable(const DFA& dfa, std::size_t acceleratedCount)
+  : mFlags{ dfa.inputCount() }
+  , mCells(dfa.stateCount() * (dfa.inputCount() + 1))
+{
+    const auto stride = mFlags + 1;
+    const auto offset = [stride](std::size_t state)
+    { return static_cast<Offset>(state * stride); };
+
+    mStart = offset(dfa.getStartState());
+    mSinkEnd = offset(dfa.sinkCount());
+    mSpecialEnd = offset(dfa.sinkCount() + acceleratedCount);
+
+    for (StateId state = 0; state < dfa.stateCount(); ++state)
+    {
+        auto* row = &mCells[offset(state)];
+        for (std::size_t input = 0; input < mFlags; ++input)
+        {
+            row[input] =
+              offset(dfa.step(state, static_cast<InputType>(input)));
+        }
+
+        row[mFlags] = dfa.isFinalState(state) ? kFinal : 0;
+    }
+}
+
+} // namespace automata
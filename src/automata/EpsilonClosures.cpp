@@ -0,0 +1,222 @@
+#include "EpsilonClosures.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace automata
+{
+
+namespace
+{
+
+constexpr auto kUnvisited = std::numeric_limits<StateId>::max();
+
+const std::vector<StateId>& epsilonSuccessors(const NFAState& state)
+{
+    static const std::vector<StateId> kNone;
+
+    const auto it = state.Transitions.find(kEpsilon);
+    return it == state.Transitions.end() ? kNone : it->second;
+}
+
+} // namespace
+
+EpsilonClosures::EpsilonClosures(const std::vector<NFAState>& states)
+  : mComponentOf(states.size(), kUnvisited)
+{
+    condense(states);
+
+    const auto componentCount = mReachesFinal.size();
+    mIsComputed.assign(componentCount, false);
+    mVisited.assign(componentCount, 0);
+    mClosures.resize(componentCount);
+}
+
+const std::vector<StateId>& EpsilonClosures::of(StateId state)
+{
+    const auto component = mComponentOf[state];
+    if (!mIsComputed[component])
+    {
+        computeClosure(component);
+    }
+    return mClosures[component];
+}
+
+bool EpsilonClosures::reachesFinal(StateId state) const
+{
+    return mReachesFinal[mComponentOf[state]];
+}
+
+void EpsilonClosures::condense(const std::vector<NFAState>& states)
+{
+    const auto stateCount = states.size();
+    mIndex.assign(stateCount, kUnvisited);
+    mLowLink.assign(stateCount, 0);
+    mOnStack.assign(stateCount, false);
+
+    // An explicit call stack of (state, next successor) pairs, since Thompson
+    // NFAs easily get deep enough to overflow a recursive search
+    std::vector<std::pair<StateId, std::size_t>> callStack;
+    StateId nextIndex = 0;
+
+    const auto visit = [&](StateId state)
+    {
+        mIndex[state] = nextIndex;
+        mLowLink[state] = nextIndex;
+        ++nextIndex;
+        mStack.push_back(state);
+        mOnStack[state] = true;
+        callStack.emplace_back(state, 0);
+    };
+
+    for (StateId root = 0; root < stateCount; ++root)
+    {
+        if (mIndex[root] != kUnvisited)
+        {
+            continue;
+        }
+
+        visit(root);
+
+        while (!callStack.empty())
+        {
+            auto& [state, next] = callStack.back();
+            const auto& successors = epsilonSuccessors(states[state]);
+
+            if (next < successors.size())
+            {
+                const auto current = state;
+                const auto successor = successors[next++];
+
+                if (mIndex[successor] == kUnvisited)
+                {
+                    visit(successor);
+                }
+                else if (mOnStack[successor])
+                {
+                    mLowLink[current] =
+                      std::min(mLowLink[current], mIndex[successor]);
+                }
+                continue;
+            }
+
+            const auto finished = state;
+            callStack.pop_back();
+
+            if (mLowLink[finished] == mIndex[finished])
+            {
+                addComponent(states, finished);
+            }
+
+            if (!callStack.empty())
+            {
+                const auto parent = callStack.back().first;
+                mLowLink[parent] =
+                  std::min(mLowLink[parent], mLowLink[finished]);
+            }
+        }
+    }
+
+    mIndex = {};
+    mLowLink = {};
+    mOnStack = {};
+    mStack = {};
+}
+
+void EpsilonClosures::addComponent(const std::vector<NFAState>& states,
+                                   StateId root)
+{
+    const auto component = static_cast<ComponentId>(mReachesFinal.size());
+    const auto firstMember = mMembers.size();
+
+    StateId member = kUnvisited;
+    while (member != root)
+    {
+        member = mStack.back();
+        mStack.pop_back();
+        mOnStack[member] = false;
+        mComponentOf[member] = component;
+        mMembers.push_back(member);
+    }
+    mMemberOffsets.push_back(mMembers.size());
+
+    // Successor components were completed before this one
+    const auto firstSuccessor = mSuccessors.size();
+    bool reachesFinal = false;
+    for (auto i = firstMember; i < mMembers.size(); ++i)
+    {
+        const auto& state = states[mMembers[i]];
+        reachesFinal = reachesFinal || state.IsFinal;
+
+        for (const auto successor : epsilonSuccessors(state))
+        {
+            const auto target = mComponentOf[successor];
+            if (target != component)
+            {
+                mSuccessors.push_back(target);
+                reachesFinal = reachesFinal || mReachesFinal[target];
+            }
+        }
+    }
+
+    const auto successorsBegin =
+      mSuccessors.begin() + static_cast<std::ptrdiff_t>(firstSuccessor);
+    std::sort(successorsBegin, mSuccessors.end());
+    mSuccessors.erase(std::unique(successorsBegin, mSuccessors.end()),
+                      mSuccessors.end());
+    mSuccessorOffsets.push_back(mSuccessors.size());
+
+    mReachesFinal.push_back(reachesFinal);
+}
+
+void EpsilonClosures::computeClosure(ComponentId component)
+{
+    auto& closure = mClosures[component];
+
+    // Depth-first over the condensation. Closures that are already known are
+    // copied instead of searched again.
+    ++mGeneration;
+    std::vector<ComponentId> stack = { component };
+    mVisited[component] = mGeneration;
+
+    while (!stack.empty())
+    {
+        const auto current = stack.back();
+        stack.pop_back();
+
+        if (mIsComputed[current])
+        {
+            closure.insert(closure.end(),
+                           mClosures[current].begin(),
+                           mClosures[current].end());
+            continue;
+        }
+
+        closure.insert(closure.end(),
+                       mMembers.begin() +
+                         static_cast<std::ptrdiff_t>(mMemberOffsets[current]),
+                       mMembers.begin() + static_cast<std::ptrdiff_t>(
+                                            mMemberOffsets[current + 1]));
+
+        for (auto i = mSuccessorOffsets[current];
+             i < mSuccessorOffsets[current + 1];
+             ++i)
+        {
+            const auto successor = mSuccessors[i];
+            if (mVisited[successor] != mGeneration)
+            {
+                mVisited[successor] = mGeneration;
+                stack.push_back(successor);
+            }
+        }
+    }
+
+    // Copied closures may overlap
+    std::sort(closure.begin(), closure.end());
+    closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+
+    mIsComputed[component] = true;
+}
+
+} // namespace automata
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Automata.hpp"
+#include "NFA.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace automata
+{
+
+// The epsilon closures of the states of an NFA. The epsilon graph is condensed
+// into its strongly connected components (Tarjan), and every state of a
+// component shares the component's closure. Closures are computed on first
+// use, so states whose closure is never asked for cost nothing beyond the
+// condensation.
+class EpsilonClosures
+{
+public:
+    explicit EpsilonClosures(const std::vector<NFAState>& states);
+
+    // The sorted states reachable from state by epsilon transitions only,
+    // including state itself
+    const std::vector<StateId>& of(StateId state);
+
+    // Whether a final state is reachable by epsilon transitions only
+    [[nodiscard]] bool reachesFinal(StateId state) const;
+
+private:
+    using ComponentId = StateId;
+
+    void condense(const std::vector<NFAState>& states);
+    void addComponent(const std::vector<NFAState>& states, StateId root);
+    void computeClosure(ComponentId component);
+
+    std::vector<ComponentId> mComponentOf;
+
+    // Members and successor components of every component in compressed
+    // sparse row form. Components are numbered in reverse topological order.
+    std::vector<std::size_t> mMemberOffsets{ 0 };
+    std::vector<StateId> mMembers;
+    std::vector<std::size_t> mSuccessorOffsets{ 0 };
+    std::vector<ComponentId> mSuccessors;
+
+    std::vector<bool> mReachesFinal;
+    std::vector<bool> mIsComputed;
+    std::vector<std::vector<StateId>> mClosures;
+
+    // Marks the components visited by the latest closure computation
+    std::vector<std::size_t> mVisited;
+    std::size_t mGeneration{ 0 };
+
+    // Tarjan's bookkeeping, released once the graph is condensed
+    std::vector<StateId> mIndex;
+    std::vector<StateId> mLowLink;
+    std::vector<bool> mOnStack;
+    std::vector<StateId> mStack;
+};
+
+} // namespace automata
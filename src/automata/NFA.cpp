@@ -1,32 +1,13 @@
 #include "NFA.hpp"
-#include "Bimap.hpp"
+#include "EpsilonClosures.hpp"
+#include "StateSetPool.hpp"
 
 #include <algorithm>
 #include <cassert>
-#include <deque>
-#include <set>
-#include <stack>
-#include <unordered_set>
 
 namespace automata
 {
 
-// todo: This hasher is too expensive (especially on non-sequential containers
-// such as sets). Need to find another way to create a bi-map or replace the
-// bi-map entirely
-struct SetHasher
-{
-    std::size_t operator()(const std::set<StateId>& V) const
-    {
-        auto hash = V.size();
-        for (const auto i : V)
-        {
-            hash ^= i + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        }
-        return hash;
-    }
-};
-
 NFAState::NFAState(StateId id, bool isStart, bool isFinal)
   : Id{ id }
   , IsStart{ isStart }
@@ -66,109 +47,146 @@ void NFA::addTransition(InputType input, StateId source, StateId destination)
     mStates.at(source).addTransition(input, destination);
 }
 
-DFA NFA::makeDFA() const
+StateId NFA::copyStates(StateId begin, StateId end)
 {
-    // Convert the NFA to a DFA
-    auto dfa = buildDFA();
+    const auto offset = mStateCount - begin;
 
-    // Minimize the DFA
-    dfa.minimize();
-
-    return dfa;
-}
-
-bool isReachableByEpsilonClosure(const EpsilonClusureMap& map,
-                                 StateId source,
-                                 StateId destination)
-{
-    const auto& reachable = map.at(source);
-    return (std::find(reachable.begin(), reachable.end(), destination) !=
-            reachable.end());
-}
-
-EpsilonClusureMap NFA::CreateEpsilonClosureMap() const
-{
-    EpsilonClusureMap map;
-
-    for (const auto& source : mStates)
+    // Add the copies first, adding states may move the originals
+    for (auto state = begin; state < end; ++state)
     {
-        auto& reachable = map[source.Id];
-
-        std::stack<StateId> stack;
-
-        stack.push(source.Id);
-        reachable.push_back(source.Id);
+        addState(false, false);
+    }
 
-        while (!stack.empty())
+    for (auto state = begin; state < end; ++state)
+    {
+        for (const auto& [input, destinations] : mStates[state].Transitions)
         {
-            const auto state = stack.top();
-            stack.pop();
-
-            const auto& transitions = mStates.at(state).Transitions;
-            if (transitions.count(kEpsilon) != 0)
+            for (const auto destination : destinations)
             {
-                for (const auto adjacent : transitions.at(kEpsilon))
+                if (destination >= begin && destination < end)
                 {
-                    if (std::find(reachable.begin(),
-                                  reachable.end(),
-                                  adjacent) == reachable.end())
-                    {
-                        stack.push(adjacent);
-                        reachable.push_back(adjacent);
-                    }
+                    addTransition(input, state + offset, destination + offset);
                 }
             }
         }
     }
 
-    return map;
+    return offset;
+}
+
+StateId NFA::size() const
+{
+    return mStateCount;
+}
+
+DFA NFA::makeDFA() const
+{
+    // Convert the NFA to a DFA
+    auto dfa = buildDFA();
+
+    // Minimize the DFA
+    dfa.minimize();
+
+    // Trim the DFA and move the sinks to the front
+    dfa.trim();
+
+    return dfa;
 }
 
 void NFA::removeEpsilonTransitions()
 {
     NFA newNFA(mAlphabet);
 
-    const auto map = CreateEpsilonClosureMap();
+    EpsilonClosures closures(mStates);
 
     // STEP1: Calculate the new states and insert them into the new NFA
 
     // Thompson-Contruction should yield an epsilon-NFA with only one final
     // state
     assert(mFinalStates.size() == 1);
-    const auto finalState = mFinalStates.front();
     for (const auto& state : mStates)
     {
-        newNFA.addState(state.IsStart,
-                        isReachableByEpsilonClosure(map, state.Id, finalState));
+        newNFA.addState(state.IsStart, closures.reachesFinal(state.Id));
     }
 
-    // STEP2: Calculate the new transitions and insert them into the new NFA
-    std::unordered_set<StateId> reachableByEpsilonClosureSet;
-    for (const auto c : mAlphabet)
+    // Only the start state and the destinations of labeled transitions are
+    // entered once epsilon transitions are gone. All other states keep their
+    // ids but need no transitions.
+    std::vector<bool> isEntered(mStates.size(), false);
+    isEntered[mStartState] = true;
+    for (const auto& state : mStates)
     {
-        for (const auto& state : mStates)
+        for (const auto& [input, destinations] : state.Transitions)
         {
-            for (const auto reachableByEpsilonClosure1 : map.at(state.Id))
+            if (input == kEpsilon)
             {
-                for (const auto destination :
-                     mStates.at(reachableByEpsilonClosure1).Transitions[c])
+                continue;
+            }
+
+            for (const auto destination : destinations)
+            {
+                isEntered[destination] = true;
+            }
+        }
+    }
+
+    // STEP2: Calculate the new transitions and insert them into the new NFA.
+    // A state inherits the labeled transitions of every state in its epsilon
+    // closure. They are batched per input, and a destination is added once
+    // per batch using generation stamps instead of clearing a set.
+    std::vector<std::vector<StateId>> batches(mAlphabet.size());
+    std::vector<std::size_t> batchStamps(mAlphabet.size(), 0);
+    std::vector<InputType> inputs;
+    std::vector<std::size_t> destinationStamps(mStates.size(), 0);
+    std::size_t generation = 0;
+
+    for (const auto& state : mStates)
+    {
+        if (!isEntered[state.Id])
+        {
+            continue;
+        }
+
+        ++generation;
+        for (const auto member : closures.of(state.Id))
+        {
+            for (const auto& [input, destinations] :
+                 mStates[member].Transitions)
+            {
+                if (input == kEpsilon)
                 {
-                    for (const auto reachableByEpsilonClosure2 :
-                         map.at(destination))
-                    {
-                        reachableByEpsilonClosureSet.insert(
-                          reachableByEpsilonClosure2);
-                    }
+                    continue;
                 }
+
+                const auto index = static_cast<std::size_t>(input);
+                if (batchStamps[index] != generation)
+                {
+                    batchStamps[index] = generation;
+                    inputs.push_back(input);
+                }
+
+                auto& batch = batches[index];
+                batch.insert(
+                  batch.end(), destinations.begin(), destinations.end());
             }
+        }
 
-            // insert into new nfa
-            for (const auto reachableByEpsilon : reachableByEpsilonClosureSet)
+        for (const auto input : inputs)
+        {
+            auto& batch = batches[static_cast<std::size_t>(input)];
+
+            ++generation;
+            for (const auto destination : batch)
             {
-                newNFA.addTransition(c, state.Id, reachableByEpsilon);
+                if (destinationStamps[destination] != generation)
+                {
+                    destinationStamps[destination] = generation;
+                    newNFA.addTransition(input, state.Id, destination);
+                }
             }
-            reachableByEpsilonClosureSet.clear();
+            batch.clear();
         }
+        inputs.clear();
     }
 
     // STEP3: replace old NFA with new NFA
@@ -177,57 +195,59 @@ void NFA::removeEpsilonTransitions()
 
 DFA NFA::buildDFA() const
 {
-    using StateMapper = Bimap<std::set<StateId>, StateId, SetHasher>;
-
     DFA dfa(mAlphabet);
-    std::deque<StateId> queue;
-    StateMapper mapper;
+    StateSetPool pool;
 
-    auto dfaState = dfa.addState(true, mStates.at(mStartState).IsFinal);
-    mapper.insert(dfaState, { mStartState });
-    queue.push_back(dfaState);
-
-    while (!queue.empty())
+    const auto isFinal = [this](const std::vector<StateId>& set)
     {
-        dfaState = queue.front();
-        queue.pop_front();
-
-        const auto& nfaStates = mapper.get(dfaState);
-
-        std::set<StateId> set;
-        for (const auto c : mAlphabet)
+        return std::any_of(set.begin(),
+                           set.end(),
+                           [this](auto stateId)
+                           { return mStates[stateId].IsFinal; });
+    };
+
+    // Every DFA state is a set of NFA states. Sets are interned in the same
+    // order as DFA states are added, so a set's id is its DFA state.
+    const std::vector<StateId> startSet = { mStartState };
+    pool.intern(startSet);
+    dfa.addState(true, isFinal(startSet));
+
+    // The NFA states reachable from the current set on each input
+    std::vector<std::vector<StateId>> destinations(mAlphabet.size());
+
+    // Sets are processed in insertion order (breadth first)
+    for (StateId dfaState = 0; dfaState < pool.size(); ++dfaState)
+    {
+        // nothing is interned until the current set has been read
+        const auto* const end = pool.end(dfaState);
+        for (const auto* it = pool.begin(dfaState); it != end; ++it)
         {
-            set.clear();
-
-            for (const auto nfaState : nfaStates)
+            for (const auto& [input, targets] : mStates[*it].Transitions)
             {
-                const auto& transitions = mStates.at(nfaState).Transitions;
-                if (transitions.count(c) != 0)
+                if (input == kEpsilon)
                 {
-                    const auto& destinations = transitions.at(c);
-                    std::copy(destinations.begin(),
-                              destinations.end(),
-                              std::inserter(set, set.end()));
+                    continue;
                 }
-            }
 
-            StateId newDfaState{};
-            if (mapper.contains(set))
-            {
-                newDfaState = mapper.get(set);
+                auto& set = destinations[static_cast<std::size_t>(input)];
+                set.insert(set.end(), targets.begin(), targets.end());
             }
-            else
+        }
+
+        for (const auto c : mAlphabet)
+        {
+            auto& set = destinations[static_cast<std::size_t>(c)];
+            std::sort(set.begin(), set.end());
+            set.erase(std::unique(set.begin(), set.end()), set.end());
+
+            const auto [newDfaState, inserted] = pool.intern(set);
+            if (inserted)
             {
-                const auto isFinal = std::any_of(
-                  set.begin(),
-                  set.end(),
-                  [this](auto stateId) { return mStates[stateId].IsFinal; });
-                newDfaState = dfa.addState(false, isFinal);
-                mapper.insert(newDfaState, set);
-                queue.push_back(newDfaState);
+                dfa.addState(false, isFinal(set));
             }
 
             dfa.addTransition(c, dfaState, newDfaState);
+            set.clear();
         }
     }
 
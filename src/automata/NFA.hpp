@@ -10,8 +10,6 @@
 namespace automata
 {
 
-using EpsilonClusureMap = std::map<StateId, std::vector<StateId>>;
-
 class NFAState
 {
 public:
@@ -34,15 +32,20 @@ public:
 
     void addTransition(InputType input, StateId source, StateId destination);
 
+    // Appends a copy of the states begin..end-1 and of the transitions
+    // between them. Returns the offset from each state to its copy.
+    StateId copyStates(StateId begin, StateId end);
+
+    [[nodiscard]] StateId size() const;
+
     [[nodiscard]] DFA makeDFA() const;
 
     void removeEpsilonTransitions();
 
-private:
-    [[nodiscard]] EpsilonClusureMap CreateEpsilonClosureMap() const;
-
+    // Subset construction without minimization
     [[nodiscard]] DFA buildDFA() const;
 
+private:
     std::vector<NFAState> mStates;
     unsigned int mStateCount{ 0 };
     StateId mStartState{};
@@ -0,0 +1,106 @@
+#include "StateSetPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace automata
+{
+
+namespace
+{
+
+constexpr auto kEmptySlot = std::numeric_limits<StateSetPool::SetId>::max();
+constexpr std::size_t kInitialSlotCount = 64;
+
+} // namespace
+
+StateSetPool::StateSetPool()
+  : mOffsets{ 0 }
+  , mSlots(kInitialSlotCount, kEmptySlot)
+{
+}
+
+std::size_t StateSetPool::hash(const std::vector<StateId>& set)
+{
+    auto hash = set.size();
+    for (const auto state : set)
+    {
+        hash ^= state + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool StateSetPool::equals(SetId id, const std::vector<StateId>& set) const
+{
+    const auto size = static_cast<std::size_t>(end(id) - begin(id));
+    return size == set.size() && std::equal(set.begin(), set.end(), begin(id));
+}
+
+std::pair<StateSetPool::SetId, bool>
+StateSetPool::intern(const std::vector<StateId>& set)
+{
+    assert(std::is_sorted(set.begin(), set.end()));
+
+    const auto setHash = hash(set);
+    const auto mask = mSlots.size() - 1;
+
+    // linear probing
+    auto slot = setHash & mask;
+    while (mSlots[slot] != kEmptySlot)
+    {
+        const auto id = mSlots[slot];
+        if (mHashes[id] == setHash && equals(id, set))
+        {
+            return { id, false };
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    const auto id = static_cast<SetId>(size());
+    mSlots[slot] = id;
+    mHashes.push_back(setHash);
+    mArena.insert(mArena.end(), set.begin(), set.end());
+    mOffsets.push_back(mArena.size());
+
+    // keep the load factor at or below one half
+    if (2 * size() > mSlots.size())
+    {
+        grow();
+    }
+
+    return { id, true };
+}
+
+void StateSetPool::grow()
+{
+    mSlots.assign(2 * mSlots.size(), kEmptySlot);
+    const auto mask = mSlots.size() - 1;
+
+    for (SetId id = 0; id < size(); ++id)
+    {
+        auto slot = mHashes[id] & mask;
+        while (mSlots[slot] != kEmptySlot)
+        {
+            slot = (slot + 1) & mask;
+        }
+        mSlots[slot] = id;
+    }
+}
+
+const StateId* StateSetPool::begin(SetId id) const
+{
+    return mArena.data() + mOffsets[id];
+}
+
+const StateId* StateSetPool::end(SetId id) const
+{
+    return mArena.data() + mOffsets[id + 1];
+}
+
+std::size_t StateSetPool::size() const
+{
+    return mHashes.size();
+}
+
+} // namespace automata
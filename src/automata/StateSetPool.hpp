@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Automata.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace automata
+{
+
+// Interns sorted sets of states. Every distinct set is stored once in a single
+// arena and identified by the order in which it was first inserted. Lookups
+// go through an open-addressing hash table that caches the hash of each set.
+class StateSetPool
+{
+public:
+    using SetId = StateId;
+
+    StateSetPool();
+
+    // Returns the id of the set and whether the set was newly inserted.
+    // The states of the set shall be sorted and unique.
+    std::pair<SetId, bool> intern(const std::vector<StateId>& set);
+
+    // The returned pointers are invalidated by the next call to intern()
+    [[nodiscard]] const StateId* begin(SetId id) const;
+    [[nodiscard]] const StateId* end(SetId id) const;
+
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    static std::size_t hash(const std::vector<StateId>& set);
+
+    [[nodiscard]] bool equals(SetId id, const std::vector<StateId>& set) const;
+
+    void grow();
+
+    std::vector<StateId> mArena;
+    std::vector<std::size_t> mOffsets;
+    std::vector<std::size_t> mHashes;
+    std::vector<SetId> mSlots;
+};
+
+} // namespace automata
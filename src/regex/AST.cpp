@@ -0,0 +1,551 @@
+#include "AST.hpp"
+
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace regex::ast
+{
+
+AST::AST(CodePoint codePointMax)
+  : mCodePointMax{ codePointMax }
+{
+}
+
+NodeId AST::add(const Node& node)
+{
+    mNodes.push_back(node);
+    return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+NodeId AST::add(NodeKind kind, const std::vector<NodeId>& children)
+{
+    Node node{ kind };
+    node.Offset = static_cast<std::uint32_t>(mChildren.size());
+    node.Count = static_cast<std::uint32_t>(children.size());
+    mChildren.insert(mChildren.end(), children.begin(), children.end());
+    return add(node);
+}
+
+NodeId AST::addAlternative(const std::vector<NodeId>& alternatives)
+{
+    return add(NodeKind::eAlternative, alternatives);
+}
+
+NodeId AST::addConcatenation(const std::vector<NodeId>& items)
+{
+    return add(NodeKind::eConcatenation, items);
+}
+
+NodeId AST::addQuantifier(NodeId inner,
+                          uint64_t min,
+                          uint64_t max,
+                          bool isMaxBounded)
+{
+    Node node{ NodeKind::eQuantifier };
+    node.Inner = inner;
+    node.Min = min;
+    node.Max = max;
+    node.IsMaxBounded = isMaxBounded;
+    return add(node);
+}
+
+NodeId AST::addEpsilon()
+{
+    return add(Node{ NodeKind::eEpsilon });
+}
+
+NodeId AST::addNull()
+{
+    return add(Node{ NodeKind::eNull });
+}
+
+NodeId AST::addCharacterClass(std::vector<CodePointInterval> intervals)
+{
+    if (intervals.empty())
+    {
+        return addNull();
+    }
+
+    merge(intervals);
+
+    Node node{ NodeKind::eCharacterClass };
+    node.Offset = static_cast<std::uint32_t>(mIntervals.size());
+    node.Count = static_cast<std::uint32_t>(intervals.size());
+    mIntervals.insert(mIntervals.end(), intervals.begin(), intervals.end());
+    return add(node);
+}
+
+NodeId AST::addCharacter(CodePoint cp)
+{
+    Node node{ NodeKind::eCharacterClass };
+    node.Offset = static_cast<std::uint32_t>(mIntervals.size());
+    node.Count = 1;
+    mIntervals.emplace_back(cp, cp);
+    return add(node);
+}
+
+void AST::setRoot(NodeId root)
+{
+    mRoot = root;
+}
+
+NodeId AST::root() const
+{
+    return mRoot;
+}
+
+CodePoint AST::codePointMax() const
+{
+    return mCodePointMax;
+}
+
+std::size_t AST::size() const
+{
+    return mNodes.size();
+}
+
+const Node& AST::operator[](NodeId id) const
+{
+    return mNodes[id];
+}
+
+Slice<NodeId> AST::children(const Node& node) const
+{
+    const auto* begin = mChildren.data() + node.Offset;
+    return { begin, begin + node.Count };
+}
+
+Slice<CodePointInterval> AST::intervals(const Node& node) const
+{
+    const auto* begin = mIntervals.data() + node.Offset;
+    return { begin, begin + node.Count };
+}
+
+template<typename Enter, typename Leave>
+void AST::traverse(Enter&& enter, Leave&& leave) const
+{
+    struct Frame
+    {
+        NodeId Id;
+        bool IsEntered;
+    };
+
+    std::vector<Frame> stack = { { mRoot, false } };
+
+    while (!stack.empty())
+    {
+        const auto id = stack.back().Id;
+
+        if (stack.back().IsEntered)
+        {
+            stack.pop_back();
+            leave(id);
+            continue;
+        }
+
+        stack.back().IsEntered = true;
+        enter(id);
+
+        // Children are pushed right to left so that they are left in order
+        const auto& node = mNodes[id];
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            case NodeKind::eConcatenation:
+            {
+                const auto nodes = children(node);
+                for (auto i = nodes.size(); i > 0; --i)
+                {
+                    stack.push_back({ nodes[i - 1], false });
+                }
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                stack.push_back({ node.Inner, false });
+                break;
+            }
+            case NodeKind::eEpsilon:
+            case NodeKind::eNull:
+            case NodeKind::eCharacterClass:
+            {
+                break;
+            }
+        }
+    }
+}
+
+std::string AST::print() const
+{
+    // Alternatives and concatenations print text between their children,
+    // so every frame remembers how many of its children were printed
+    struct Frame
+    {
+        NodeId Id;
+        std::size_t Printed;
+    };
+
+    std::string str;
+    std::vector<Frame> stack = { { mRoot, 0 } };
+
+    while (!stack.empty())
+    {
+        const auto [id, printed] = stack.back();
+        const auto& node = mNodes[id];
+        ++stack.back().Printed;
+
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            case NodeKind::eConcatenation:
+            {
+                const auto nodes = children(node);
+                const auto* separator =
+                  node.Kind == NodeKind::eAlternative ? "|" : "";
+                if (printed == nodes.size())
+                {
+                    str += ")";
+                    stack.pop_back();
+                }
+                else
+                {
+                    str += (printed == 0) ? "(" : separator;
+                    stack.push_back({ nodes[printed], 0 });
+                }
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                if (printed == 0)
+                {
+                    stack.push_back({ node.Inner, 0 });
+                }
+                else if (node.IsMaxBounded)
+                {
+                    str += "{" + std::to_string(node.Min) + "," +
+                           std::to_string(node.Max) + "}";
+                    stack.pop_back();
+                }
+                else
+                {
+                    str += "{" + std::to_string(node.Min) + "," + "}";
+                    stack.pop_back();
+                }
+                break;
+            }
+            case NodeKind::eEpsilon:
+            case NodeKind::eNull:
+            {
+                stack.pop_back();
+                break;
+            }
+            case NodeKind::eCharacterClass:
+            {
+                std::stringstream ss;
+                ss << "[";
+                for (const auto& [start, end] : intervals(node))
+                {
+                    ss << "\\U" << std::hex << std::setfill('0')
+                       << std::setw(8) << start;
+                    ss << "-";
+                    ss << "\\U" << std::hex << std::setfill('0')
+                       << std::setw(8) << end;
+                }
+                ss << "]";
+                str += ss.str();
+                stack.pop_back();
+                break;
+            }
+        }
+    }
+
+    return str;
+}
+
+Alphabet AST::makeAlphabet() const
+{
+    Alphabet alphabet;
+
+    traverse([](NodeId) {},
+             [this, &alphabet](NodeId id)
+             {
+                 const auto& node = mNodes[id];
+                 if (node.Kind == NodeKind::eCharacterClass)
+                 {
+                     const auto classIntervals = intervals(node);
+                     alphabet.insert(alphabet.end(),
+                                     classIntervals.begin(),
+                                     classIntervals.end());
+                 }
+             });
+
+    disjoinOverlap(alphabet, kCodePointMin, mCodePointMax);
+    return alphabet;
+}
+
+NFA AST::makeEpsilonNFA(const Alphabet& alphabet) const
+{
+    // Make the NFA's alphabet
+    auto nfaAlphabet = automata::Alphabet(alphabet.size());
+    std::iota(std::begin(nfaAlphabet), std::end(nfaAlphabet), 0);
+
+    // Make the empty NFA
+    auto nfa = NFA(nfaAlphabet);
+
+    // Populate the NFA using thompson construction. Every subtree is lowered
+    // into a contiguous range of states, recorded when entering its root.
+    std::vector<BlackBox> results;
+    std::vector<StateId> begins;
+    std::vector<InputRange> ranges;
+
+    const auto pop = [&results]()
+    {
+        const auto bb = results.back();
+        results.pop_back();
+        return bb;
+    };
+
+    const auto enter = [&nfa, &begins](NodeId)
+    { begins.push_back(nfa.size()); };
+
+    const auto leave = [&](NodeId id)
+    {
+        const auto& node = mNodes[id];
+        const auto begin = begins.back();
+        begins.pop_back();
+
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            {
+                auto entry = nfa.addState(false, false);
+                auto exit = nfa.addState(false, false);
+
+                const auto first = results.end() - node.Count;
+                for (auto it = first; it != results.end(); ++it)
+                {
+                    nfa.addTransition(automata::kEpsilon, entry, it->Entry);
+                    nfa.addTransition(automata::kEpsilon, it->Exit, exit);
+                }
+
+                results.erase(first, results.end());
+                results.emplace_back(entry, exit);
+                break;
+            }
+            case NodeKind::eConcatenation:
+            {
+                const auto first = results.end() - node.Count;
+                for (auto it = std::next(first); it != results.end(); ++it)
+                {
+                    nfa.addTransition(
+                      automata::kEpsilon, std::prev(it)->Exit, it->Entry);
+                }
+
+                const auto bb = BlackBox(first->Entry, results.back().Exit);
+                results.erase(first, results.end());
+                results.push_back(bb);
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                // The inner expression is lowered once. Every further
+                // repetition copies its states.
+                const auto inner = pop();
+                const auto end = nfa.size();
+                auto first = true;
+                const auto next = [&]()
+                {
+                    if (first)
+                    {
+                        first = false;
+                        return inner;
+                    }
+                    const auto offset = nfa.copyStates(begin, end);
+                    return BlackBox(inner.Entry + offset, inner.Exit + offset);
+                };
+
+                auto entry = nfa.addState(false, false);
+                auto exit = nfa.addState(false, false);
+                auto prev = entry;
+
+                for (uint64_t min = 0; min < node.Min; ++min)
+                {
+                    const auto copy = next();
+                    nfa.addTransition(automata::kEpsilon, prev, copy.Entry);
+                    prev = copy.Exit;
+                }
+
+                if (node.IsMaxBounded)
+                {
+                    for (uint64_t max = node.Min; max < node.Max; ++max)
+                    {
+                        const auto copy = next();
+                        nfa.addTransition(automata::kEpsilon, prev, copy.Entry);
+                        nfa.addTransition(automata::kEpsilon, prev, exit);
+                        prev = copy.Exit;
+                    }
+                }
+                else
+                {
+                    const auto copy = next();
+                    nfa.addTransition(automata::kEpsilon, prev, copy.Entry);
+                    nfa.addTransition(automata::kEpsilon, prev, exit);
+                    nfa.addTransition(
+                      automata::kEpsilon, copy.Exit, copy.Entry);
+                    prev = copy.Exit;
+                }
+
+                nfa.addTransition(automata::kEpsilon, prev, exit);
+                results.emplace_back(entry, exit);
+                break;
+            }
+            case NodeKind::eEpsilon:
+            {
+                auto entry = nfa.addState(false, false);
+                auto exit = nfa.addState(false, false);
+                nfa.addTransition(automata::kEpsilon, entry, exit);
+                results.emplace_back(entry, exit);
+                break;
+            }
+            case NodeKind::eNull:
+            {
+                // entry and exit are not connected by any transition
+                auto entry = nfa.addState(false, false);
+                auto exit = nfa.addState(false, false);
+                results.emplace_back(entry, exit);
+                break;
+            }
+            case NodeKind::eCharacterClass:
+            {
+                auto entry = nfa.addState(false, false);
+                auto exit = nfa.addState(false, false);
+
+                // A single pair of states for the whole class
+                ranges.clear();
+                addInputRanges(alphabet, intervals(node), ranges);
+                for (const auto& [first, last] : ranges)
+                {
+                    for (auto input = first; input <= last; ++input)
+                    {
+                        nfa.addTransition(input, entry, exit);
+                    }
+                }
+
+                results.emplace_back(entry, exit);
+                break;
+            }
+        }
+    };
+
+    traverse(enter, leave);
+
+    auto bb = results.back();
+    auto start = nfa.addState(true, false);
+    auto end = nfa.addState(false, true);
+    nfa.addTransition(automata::kEpsilon, start, bb.Entry);
+    nfa.addTransition(automata::kEpsilon, bb.Exit, end);
+
+    return nfa;
+}
+
+NFA AST::makeThompsonNFA(const Alphabet& alphabet) const
+{
+    auto nfa = makeEpsilonNFA(alphabet);
+
+    // The NFA built via Thompson-Construction is an "Epsilon NFA"
+    // Such NFA contains epsilon transitions. Removal of said
+    // transitions yields a standard NFA.
+    nfa.removeEpsilonTransitions();
+
+    return nfa;
+}
+
+NFA AST::makeNFA(const Alphabet& alphabet) const
+{
+    using Positions = PositionAutomaton::Positions;
+
+    // The position automaton is epsilon free by construction. Every subtree
+    // is lowered into a contiguous range of positions, recorded when
+    // entering its root.
+    auto automaton = PositionAutomaton(alphabet);
+    std::vector<Positions> results;
+    std::vector<StateId> begins;
+
+    const auto pop = [&results]()
+    {
+        auto positions = std::move(results.back());
+        results.pop_back();
+        return positions;
+    };
+
+    const auto enter = [&automaton, &begins](NodeId)
+    { begins.push_back(automaton.size()); };
+
+    const auto leave = [&](NodeId id)
+    {
+        const auto& node = mNodes[id];
+        const auto begin = begins.back();
+        begins.pop_back();
+
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            {
+                const auto first = results.end() - node.Count;
+                auto positions = std::move(*first);
+                for (auto it = std::next(first); it != results.end(); ++it)
+                {
+                    positions = PositionAutomaton::alternate(
+                      std::move(positions), std::move(*it));
+                }
+
+                results.erase(first, results.end());
+                results.push_back(std::move(positions));
+                break;
+            }
+            case NodeKind::eConcatenation:
+            {
+                const auto first = results.end() - node.Count;
+                auto positions = std::move(*first);
+                for (auto it = std::next(first); it != results.end(); ++it)
+                {
+                    positions = automaton.concatenate(std::move(positions),
+                                                      std::move(*it));
+                }
+
+                results.erase(first, results.end());
+                results.push_back(std::move(positions));
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                results.push_back(automaton.quantify(
+                  pop(), begin, node.Min, node.Max, node.IsMaxBounded));
+                break;
+            }
+            case NodeKind::eEpsilon:
+            {
+                results.push_back(Positions{ true, {}, {} });
+                break;
+            }
+            case NodeKind::eNull:
+            {
+                // matches nothing, not even the empty string
+                results.push_back(Positions{ false, {}, {} });
+                break;
+            }
+            case NodeKind::eCharacterClass:
+            {
+                results.push_back(automaton.addPosition(intervals(node)));
+                break;
+            }
+        }
+    };
+
+    traverse(enter, leave);
+
+    return automaton.makeNFA(results.back());
+}
+
+} // namespace regex::ast
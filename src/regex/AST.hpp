@@ -4,16 +4,18 @@
 #include "CodePoint.hpp"
 #include "NFA.hpp"
 
-#include <iomanip>
-#include <memory>
+#include <algorithm>
+#include <cstdint>
 #include <numeric>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace regex::ast
 {
 
+using automata::NFA;
 using automata::StateId;
 
 struct BlackBox
@@ -28,325 +30,415 @@ struct BlackBox
     StateId Exit;
 };
 
-class Node;
-using NodePtr = std::unique_ptr<Node>;
-using automata::NFA;
-
-class Node
+// A view of consecutive elements of one of the AST's arrays
+template<typename T>
+class Slice
 {
 public:
-    [[nodiscard]] virtual BlackBox makeNFA(const Alphabet& alphabet,
-                                           NFA& nfa) const = 0;
-    virtual void print(std::string&) const = 0;
-    virtual void makeAlphabet(Alphabet&) const = 0;
-    virtual ~Node() = default;
-
-    Node() = default;
-
-    // no copy
-    Node(const Node&) = delete;
-    Node& operator=(const Node&) = delete;
-
-    // move allowed
-    Node(Node&&) = default;
-    Node& operator=(Node&&) = default;
-};
+    Slice(const T* begin, const T* end)
+      : mBegin{ begin }
+      , mEnd{ end }
+    {
+    }
 
-class Alternative : public Node
-{
-public:
-    Alternative(NodePtr& lhs, NodePtr& rhs)
-      : mLeft{ std::move(lhs) }
-      , mRight{ std::move(rhs) }
+    [[nodiscard]] const T* begin() const
     {
+        return mBegin;
     }
 
-    [[nodiscard]] BlackBox makeNFA(const Alphabet& alphabet,
-                                   NFA& nfa) const final
+    [[nodiscard]] const T* end() const
     {
-        auto BB1 = mLeft->makeNFA(alphabet, nfa);
-        auto BB2 = mRight->makeNFA(alphabet, nfa);
-
-        auto entry = nfa.addState(false, false);
-        auto exit = nfa.addState(false, false);
-        nfa.addTransition(automata::kEpsilon, entry, BB1.Entry);
-        nfa.addTransition(automata::kEpsilon, entry, BB2.Entry);
-        nfa.addTransition(automata::kEpsilon, BB1.Exit, exit);
-        nfa.addTransition(automata::kEpsilon, BB2.Exit, exit);
-        return BlackBox(entry, exit);
+        return mEnd;
     }
 
-    void makeAlphabet(Alphabet& alphabet) const final
+    [[nodiscard]] std::size_t size() const
     {
-        mLeft->makeAlphabet(alphabet);
-        mRight->makeAlphabet(alphabet);
+        return static_cast<std::size_t>(mEnd - mBegin);
     }
 
-    void print(std::string& str) const final
+    [[nodiscard]] const T& operator[](std::size_t index) const
     {
-        str += "(";
-        mLeft->print(str);
-        str += "|";
-        mRight->print(str);
-        str += ")";
+        return mBegin[index];
     }
 
-    NodePtr mLeft;
-    NodePtr mRight;
+private:
+    const T* mBegin;
+    const T* mEnd;
 };
 
-class Concatenation : public Node
+// The first and last input of a run of consecutive inputs
+using InputRange = std::pair<automata::InputType, automata::InputType>;
+
+// Appends the inputs matching the sorted and disjoint intervals of a class to
+// ranges. The alphabet is built from the endpoints of every class, so each
+// interval maps onto the run of inputs between the symbols holding its
+// endpoints, found by binary search.
+inline void addInputRanges(const Alphabet& alphabet,
+                           Slice<CodePointInterval> intervals,
+                           std::vector<InputRange>& ranges)
 {
-public:
-    Concatenation(NodePtr& lhs, NodePtr& rhs)
-      : mLeft{ std::move(lhs) }
-      , mRight{ std::move(rhs) }
+    for (const auto& [first, last] : intervals)
     {
+        ranges.emplace_back(
+          static_cast<automata::InputType>(findInterval(alphabet, first)),
+          static_cast<automata::InputType>(findInterval(alphabet, last)));
     }
+}
 
-    [[nodiscard]] BlackBox makeNFA(const Alphabet& alphabet,
-                                   NFA& nfa) const final
+// Builds the position (Glushkov) automaton of an AST. Every character class
+// of the AST is a position and becomes one NFA state. Transitions follow the
+// followpos relation, so the automaton never has epsilon transitions.
+class PositionAutomaton
+{
+public:
+    // The positions a subexpression can start and end with
+    struct Positions
     {
-        auto BB1 = mLeft->makeNFA(alphabet, nfa);
-        auto BB2 = mRight->makeNFA(alphabet, nfa);
-
-        auto entry = BB1.Entry;
-        auto exit = BB2.Exit;
-        nfa.addTransition(automata::kEpsilon, BB1.Exit, BB2.Entry);
-        return BlackBox(entry, exit);
-    }
-
-    void makeAlphabet(Alphabet& alphabet) const final
+        bool Nullable{ false };
+        std::vector<StateId> First;
+        std::vector<StateId> Last;
+    };
+
+    explicit PositionAutomaton(const Alphabet& alphabet)
+      : mAlphabet{ alphabet }
+      , mLabels(1)
+      , mFollow(1)
     {
-        mLeft->makeAlphabet(alphabet);
-        mRight->makeAlphabet(alphabet);
+        // position 0 is the start state
     }
 
-    void print(std::string& str) const final
+    [[nodiscard]] Positions addPosition(Slice<CodePointInterval> intervals)
     {
-        str += "(";
-        mLeft->print(str);
-        mRight->print(str);
-        str += ")";
+        checkLimit(1);
+        const auto begin = mInputRanges.size();
+        addInputRanges(mAlphabet, intervals, mInputRanges);
+
+        const auto position = size();
+        mLabels.emplace_back(begin, mInputRanges.size());
+        mFollow.emplace_back();
+        return Positions{ false, { position }, { position } };
     }
 
-    NodePtr mLeft;
-    NodePtr mRight;
-};
+    // Counted repetitions are expanded, so the number of positions is capped
+    // to fail early on patterns whose automata would exhaust memory
+    static constexpr uint64_t kMaxPositions = uint64_t{ 1 } << 20;
 
-class Quantifier : public Node
-{
-public:
-    Quantifier(NodePtr& inner, uint64_t min, uint64_t max, bool isMaxBounded)
-      : mInner{ std::move(inner) }
-      , mMin{ min }
-      , mMax{ max }
-      , mIsMaxBounded{ isMaxBounded }
+    [[nodiscard]] StateId size() const
     {
+        return static_cast<StateId>(mLabels.size());
     }
 
-    [[nodiscard]] BlackBox makeNFA(const Alphabet& alphabet,
-                                   NFA& nfa) const final
+    // Throws when count more positions would exceed the cap
+    void checkLimit(uint64_t count) const
     {
-        auto entry = nfa.addState(false, false);
-        auto exit = nfa.addState(false, false);
-        auto prev = entry;
-
-        for (uint64_t min = 0; min < mMin; ++min)
+        if (count > kMaxPositions - mLabels.size())
         {
-            auto next = mInner->makeNFA(alphabet, nfa);
-            nfa.addTransition(automata::kEpsilon, prev, next.Entry);
-            prev = next.Exit;
+            throw std::runtime_error(
+              "The pattern exceeds the limit of " +
+              std::to_string(kMaxPositions) +
+              " positions after expanding counted repetitions");
         }
+    }
 
-        if (mIsMaxBounded)
+    // Copies the positions begin..end-1 and the follow entries between them.
+    // positions shall only refer to positions within that range.
+    [[nodiscard]] Positions clone(const Positions& positions,
+                                  StateId begin,
+                                  StateId end)
+    {
+        checkLimit(end - begin);
+        const auto offset = size() - begin;
+
+        for (auto position = begin; position < end; ++position)
         {
-            for (uint64_t max = mMin; max < mMax; ++max)
+            std::vector<StateId> follow;
+            for (const auto next : mFollow[position])
             {
-                auto next = mInner->makeNFA(alphabet, nfa);
-                nfa.addTransition(automata::kEpsilon, prev, next.Entry);
-                nfa.addTransition(automata::kEpsilon, prev, exit);
-                prev = next.Exit;
+                if (next >= begin && next < end)
+                {
+                    follow.push_back(next + offset);
+                }
             }
-        }
-        else
-        {
-            auto next = mInner->makeNFA(alphabet, nfa);
-            nfa.addTransition(automata::kEpsilon, prev, next.Entry);
-            nfa.addTransition(automata::kEpsilon, prev, exit);
-            nfa.addTransition(automata::kEpsilon, next.Exit, next.Entry);
-            prev = next.Exit;
+
+            mLabels.push_back(mLabels[position]);
+            mFollow.push_back(std::move(follow));
         }
 
-        nfa.addTransition(automata::kEpsilon, prev, exit);
-        return BlackBox(entry, exit);
-    }
+        const auto shift = [offset](std::vector<StateId> ids)
+        {
+            for (auto& id : ids)
+            {
+                id += offset;
+            }
+            return ids;
+        };
 
-    void makeAlphabet(Alphabet& alphabet) const final
-    {
-        mInner->makeAlphabet(alphabet);
+        return Positions{ positions.Nullable,
+                          shift(positions.First),
+                          shift(positions.Last) };
     }
 
-    void print(std::string& str) const final
+    [[nodiscard]] Positions concatenate(Positions lhs, Positions rhs)
     {
-        mInner->print(str);
-        if (mIsMaxBounded)
+        for (const auto last : lhs.Last)
         {
-            str +=
-              "{" + std::to_string(mMin) + "," + std::to_string(mMax) + "}";
+            auto& follow = mFollow[last];
+            follow.insert(follow.end(), rhs.First.begin(), rhs.First.end());
         }
-        else
+
+        if (lhs.Nullable)
         {
-            str += "{" + std::to_string(mMin) + "," + "}";
+            lhs.First.insert(
+              lhs.First.end(), rhs.First.begin(), rhs.First.end());
         }
-    }
-
-    NodePtr mInner;
-    uint64_t mMin;
-    uint64_t mMax;
-    bool mIsMaxBounded;
-};
 
-class Epsilon : public Node
-{
-public:
-    [[nodiscard]] BlackBox makeNFA(const Alphabet&, NFA& nfa) const final
-    {
-        auto entry = nfa.addState(false, false);
-        auto exit = nfa.addState(false, false);
-        nfa.addTransition(automata::kEpsilon, entry, exit);
-        return BlackBox(entry, exit);
-    }
+        if (rhs.Nullable)
+        {
+            rhs.Last.insert(rhs.Last.end(), lhs.Last.begin(), lhs.Last.end());
+        }
 
-    void makeAlphabet(Alphabet&) const final
-    { /* Do nothing */
+        return Positions{ lhs.Nullable && rhs.Nullable,
+                          std::move(lhs.First),
+                          std::move(rhs.Last) };
     }
 
-    void print(std::string& str) const final { str += ""; }
-};
-
-class Null : public Node
-{
-public:
-    [[nodiscard]] BlackBox makeNFA(const Alphabet&, NFA& nfa) const final
+    [[nodiscard]] static Positions alternate(Positions lhs, Positions rhs)
     {
-        // entry and exit are not connected by any transition
-        auto entry = nfa.addState(false, false);
-        auto exit = nfa.addState(false, false);
-        return BlackBox(entry, exit);
+        lhs.Nullable = lhs.Nullable || rhs.Nullable;
+        lhs.First.insert(lhs.First.end(), rhs.First.begin(), rhs.First.end());
+        lhs.Last.insert(lhs.Last.end(), rhs.Last.begin(), rhs.Last.end());
+        return lhs;
     }
 
-    void makeAlphabet(Alphabet&) const final
-    { /* Do nothing */
-    }
-
-    void print(std::string& str) const final { str += ""; }
-};
-
-class CharacterRange : public Node
-{
-public:
-    CharacterRange(CodePoint start, CodePoint end)
-      : mStart{ start }
-      , mEnd{ end }
+    // One or more repetitions
+    [[nodiscard]] Positions repeat(Positions positions)
     {
+        for (const auto last : positions.Last)
+        {
+            auto& follow = mFollow[last];
+            follow.insert(
+              follow.end(), positions.First.begin(), positions.First.end());
+        }
+        return positions;
     }
 
-    explicit CharacterRange(CodePoint codepoint)
-      : mStart{ codepoint }
-      , mEnd{ codepoint }
+    [[nodiscard]] static Positions optional(Positions positions)
     {
+        positions.Nullable = true;
+        return positions;
     }
 
-    [[nodiscard]] BlackBox makeNFA(const Alphabet& alphabet,
-                                   NFA& nfa) const final
+    // Repeats inner, whose positions are begin..size()-1, between min and max
+    // times. The inner expression is lowered once. Further repetitions clone
+    // its positions rather than traversing the inner expression again.
+    [[nodiscard]] Positions quantify(Positions inner,
+                                     StateId begin,
+                                     uint64_t min,
+                                     uint64_t max,
+                                     bool isMaxBounded)
     {
-        auto interval = CodePointInterval{ mStart, mEnd };
+        auto positions = Positions{ true, {}, {} };
 
-        auto entry = nfa.addState(false, false);
-        auto exit = nfa.addState(false, false);
+        // x{n,} is lowered as n-1 copies followed by x+, and x{0,} as x*
+        const auto copyCount =
+          isMaxBounded ? max : std::max(min, uint64_t{ 1 });
+        if (copyCount == 0)
+        {
+            return positions;
+        }
 
-        for (auto i = 0U; i < alphabet.size(); ++i)
+        // Without positions the inner expression matches only the empty
+        // string or nothing at all, no matter how often it is repeated
+        const auto end = size();
+        if (begin == end)
         {
-            if (isSubset(alphabet[i], interval))
-            {
-                nfa.addTransition(
-                  static_cast<automata::InputType>(i), entry, exit);
-            }
+            return Positions{ min == 0 || inner.Nullable, {}, {} };
         }
 
-        return BlackBox(entry, exit);
-    }
+        checkLimit((copyCount - 1) * (end - begin));
 
-    void makeAlphabet(Alphabet& alphabet) const final
-    {
-        alphabet.emplace_back(mStart, mEnd);
-    }
-
-    void print(std::string& str) const final
-    {
-        std::stringstream ss;
-        ss << "[";
-        ss << "\\U" << std::hex << std::setfill('0') << std::setw(8) << mStart;
-        ss << "-";
-        ss << "\\U" << std::hex << std::setfill('0') << std::setw(8) << mEnd;
-        ss << "]";
-        str += ss.str();
-    }
+        std::vector<Positions> copies;
+        copies.reserve(static_cast<std::size_t>(copyCount));
+        copies.push_back(inner);
+        for (uint64_t copy = 1; copy < copyCount; ++copy)
+        {
+            copies.push_back(clone(inner, begin, end));
+        }
 
-    CodePoint mStart;
-    CodePoint mEnd;
-};
+        const auto mandatoryCount = isMaxBounded ? min : copyCount - 1;
+        for (uint64_t copy = 0; copy < mandatoryCount; ++copy)
+        {
+            positions =
+              concatenate(std::move(positions), std::move(copies[copy]));
+        }
 
-class AST
-{
-public:
-    explicit AST(NodePtr& node)
-      : mRoot{ std::move(node) }
-    {
-    }
+        if (isMaxBounded)
+        {
+            // Nest the optional repetitions as in (x(x(x)?)?)? rather than
+            // x?x?x?, which would follow every copy by all later copies
+            auto tail = Positions{ true, {}, {} };
+            for (auto copy = max; copy > min; --copy)
+            {
+                tail = optional(
+                  concatenate(std::move(copies[copy - 1]), std::move(tail)));
+            }
 
-    [[nodiscard]] std::string print() const
-    {
-        std::string str;
-        mRoot->print(str);
-        return str;
-    }
+            positions = concatenate(std::move(positions), std::move(tail));
+        }
+        else
+        {
+            auto plus = repeat(std::move(copies[mandatoryCount]));
+            if (min == 0)
+            {
+                plus = optional(std::move(plus));
+            }
+            positions = concatenate(std::move(positions), std::move(plus));
+        }
 
-    [[nodiscard]] Alphabet makeAlphabet() const
-    {
-        Alphabet alphabet;
-        mRoot->makeAlphabet(alphabet);
-        disjoinOverlap(alphabet, kCodePointMin, kCodePointMax);
-        return alphabet;
+        return positions;
     }
 
-    [[nodiscard]] NFA makeNFA(const Alphabet& alphabet) const
+    [[nodiscard]] NFA makeNFA(const Positions& root) const
     {
         // Make the NFA's alphabet
-        auto nfaAlphabet = automata::Alphabet(alphabet.size());
+        auto nfaAlphabet = automata::Alphabet(mAlphabet.size());
         std::iota(std::begin(nfaAlphabet), std::end(nfaAlphabet), 0);
 
-        // Make the empty NFA
         auto nfa = NFA(nfaAlphabet);
 
-        // Populate the NFA using thompson construction
-        auto bb = mRoot->makeNFA(alphabet, nfa);
-        auto start = nfa.addState(true, false);
-        auto end = nfa.addState(false, true);
-        nfa.addTransition(automata::kEpsilon, start, bb.Entry);
-        nfa.addTransition(automata::kEpsilon, bb.Exit, end);
+        std::vector<bool> isLast(mLabels.size(), false);
+        for (const auto last : root.Last)
+        {
+            isLast[last] = true;
+        }
+
+        nfa.addState(true, root.Nullable);
+        for (auto position = 1U; position < mLabels.size(); ++position)
+        {
+            nfa.addState(false, isLast[position]);
+        }
 
-        // The NFA built via Thompson-Construction is an "Epsilon NFA"
-        // Such NFA contains epsilon transitions. Removal of said
-        // transitions yields a standard NFA.
-        nfa.removeEpsilonTransitions();
+        // A transition into a position is labeled with the position's inputs.
+        // Stamps drop follow entries repeated by nested repetitions.
+        std::vector<StateId> stamps(mLabels.size(), 0);
+        for (StateId source = 0; source < mLabels.size(); ++source)
+        {
+            const auto& follow = source == 0 ? root.First : mFollow[source];
+            for (const auto destination : follow)
+            {
+                if (stamps[destination] == source + 1)
+                {
+                    continue;
+                }
+                stamps[destination] = source + 1;
+
+                const auto [begin, end] = mLabels[destination];
+                for (auto range = begin; range < end; ++range)
+                {
+                    const auto [first, last] = mInputRanges[range];
+                    for (auto input = first; input <= last; ++input)
+                    {
+                        nfa.addTransition(input, source, destination);
+                    }
+                }
+            }
+        }
 
         return nfa;
     }
 
 private:
-    NodePtr mRoot;
+    // The input ranges matched by a position, an index range into
+    // mInputRanges. Cloned positions share the ranges of their original.
+    using Label = std::pair<std::size_t, std::size_t>;
+
+    const Alphabet& mAlphabet;
+    std::vector<InputRange> mInputRanges;
+    std::vector<Label> mLabels;
+    std::vector<std::vector<StateId>> mFollow;
+};
+
+using NodeId = std::uint32_t;
+
+enum class NodeKind : std::uint8_t
+{
+    eAlternative,
+    eConcatenation,
+    eQuantifier,
+    eEpsilon,
+    eNull,
+    eCharacterClass
+};
+
+// A node of the AST. Nodes live in a single array owned by the AST and refer
+// to their children by index. Which fields are used depends on the kind.
+struct Node
+{
+    NodeKind Kind;
+
+    // Quantifier
+    NodeId Inner{};
+    uint64_t Min{};
+    uint64_t Max{};
+    bool IsMaxBounded{};
+
+    // Alternative and Concatenation keep their children and CharacterClass
+    // its intervals in an array of the AST, starting at Offset
+    std::uint32_t Offset{};
+    std::uint32_t Count{};
+};
+
+class AST
+{
+public:
+    explicit AST(CodePoint codePointMax = kCodePointMax);
+
+    // Children shall be added before their parents. Alternatives and
+    // concatenations shall have at least one child.
+    NodeId addAlternative(const std::vector<NodeId>& alternatives);
+    NodeId addConcatenation(const std::vector<NodeId>& items);
+    NodeId addQuantifier(NodeId inner,
+                         uint64_t min,
+                         uint64_t max,
+                         bool isMaxBounded);
+    NodeId addEpsilon();
+    NodeId addNull();
+
+    // The intervals are sorted and merged. Without any interval the class
+    // matches nothing and a Null node is added instead.
+    NodeId addCharacterClass(std::vector<CodePointInterval> intervals);
+    NodeId addCharacter(CodePoint cp);
+
+    void setRoot(NodeId root);
+    [[nodiscard]] NodeId root() const;
+    [[nodiscard]] CodePoint codePointMax() const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] const Node& operator[](NodeId id) const;
+    [[nodiscard]] Slice<NodeId> children(const Node& node) const;
+    [[nodiscard]] Slice<CodePointInterval> intervals(const Node& node) const;
+
+    [[nodiscard]] std::string print() const;
+    [[nodiscard]] Alphabet makeAlphabet() const;
+    [[nodiscard]] NFA makeEpsilonNFA(const Alphabet& alphabet) const;
+    [[nodiscard]] NFA makeThompsonNFA(const Alphabet& alphabet) const;
+    [[nodiscard]] NFA makeNFA(const Alphabet& alphabet) const;
+
+private:
+    NodeId add(const Node& node);
+    NodeId add(NodeKind kind, const std::vector<NodeId>& children);
+
+    // Calls enter(id) before and leave(id) after the children of every node
+    // below and including root. Uses an explicit stack rather than recursion.
+    template<typename Enter, typename Leave>
+    void traverse(Enter&& enter, Leave&& leave) const;
+
+    std::vector<Node> mNodes;
+    std::vector<NodeId> mChildren;
+    std::vector<CodePointInterval> mIntervals;
+    NodeId mRoot{};
+    CodePoint mCodePointMax;
 };
 
 } // namespace regex::ast
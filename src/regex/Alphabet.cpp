@@ -2,73 +2,47 @@
 #include "Alphabet.hpp"
 
 #include <algorithm>
-#include <set>
+#include <cstdint>
 
 namespace regex
 {
 
-bool isSubset(const CodePointInterval inner, const CodePointInterval outer)
-{
-    return (outer.first <= inner.first && outer.second >= inner.second);
-}
-
 void disjoinOverlap(Alphabet& alphabet, CodePoint min, CodePoint max)
 {
-    enum class EndpointType
-    {
-        eStart,
-        eEnd
-    };
-    using Point = std::pair<CodePoint, EndpointType>;
-    using Points = std::set<Point>;
+    // Every interval starts at min or right after an endpoint. These cut
+    // points are 64 bits wide so that one past max does not overflow.
+    std::vector<uint64_t> cuts;
+    cuts.reserve(alphabet.size() * 2 + 1);
+    cuts.push_back(min);
 
-    auto points = Points{};
-
-    for (const auto& codePointInterval : alphabet)
+    for (const auto& [first, last] : alphabet)
     {
-        points.emplace(codePointInterval.first, EndpointType::eStart);
-        points.emplace(codePointInterval.second, EndpointType::eEnd);
+        cuts.push_back(first);
+        cuts.push_back(uint64_t{ last } + 1);
     }
     alphabet.clear();
 
-    // this needs to be large enough to prevent overflow errors
-    unsigned long long int current = min;
-
-    for (const auto& point : points)
-    {
-        if (point.second == EndpointType::eStart)
-        {
-            if (current < point.first)
-            {
-                alphabet.emplace_back(current, point.first - 1);
-                current = point.first;
-            }
-        }
-        else
-        {
-            alphabet.emplace_back(current, point.first);
-            current = point.first + 1;
-        }
-    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
 
-    if (current < max)
+    for (auto i = 0U; i < cuts.size() && cuts[i] <= max; ++i)
     {
-        alphabet.emplace_back(current, max);
+        const auto last =
+          i + 1 < cuts.size() ? std::min<uint64_t>(cuts[i + 1] - 1, max) : max;
+        alphabet.emplace_back(static_cast<CodePoint>(cuts[i]),
+                              static_cast<CodePoint>(last));
     }
 }
 
-void negate(Alphabet& alphabet)
+void negate(Alphabet& alphabet, CodePoint min, CodePoint max)
 {
-    std::sort(alphabet.begin(),
-              alphabet.end(),
-              [](const CodePointInterval& a, const CodePointInterval& b)
-              { return a.first < b.second; });
+    merge(alphabet);
 
     Alphabet swapped;
     std::swap(swapped, alphabet);
 
     // this needs to be large enough to prevent overflow errors
-    unsigned long long int current = kCodePointMin;
+    unsigned long long int current = min;
 
     for (const auto& interval : swapped)
     {
@@ -79,10 +53,44 @@ void negate(Alphabet& alphabet)
         current = interval.second + 1;
     }
 
-    if (current < kCodePointMax)
+    if (current <= max)
     {
-        alphabet.emplace_back(current, kCodePointMax);
+        alphabet.emplace_back(current, max);
+    }
+}
+
+void merge(Alphabet& alphabet)
+{
+    std::sort(alphabet.begin(), alphabet.end());
+
+    Alphabet sorted;
+    std::swap(sorted, alphabet);
+
+    for (const auto& interval : sorted)
+    {
+        // this needs to be large enough to prevent overflow errors
+        if (!alphabet.empty() &&
+            interval.first <=
+              static_cast<unsigned long long int>(alphabet.back().second) + 1)
+        {
+            alphabet.back().second =
+              std::max(alphabet.back().second, interval.second);
+            continue;
+        }
+        alphabet.push_back(interval);
     }
 }
 
-}
\ No newline at end of file
+std::size_t findInterval(const Alphabet& alphabet, CodePoint codePoint)
+{
+    const auto startsAfter = [](CodePoint value, CodePointInterval interval)
+    { return value < interval.first; };
+
+    const auto next = std::upper_bound(
+      alphabet.begin(), alphabet.end(), codePoint, startsAfter);
+
+    return static_cast<std::size_t>(std::distance(alphabet.begin(), next)) -
+           1;
+}
+
+}
@@ -3,6 +3,7 @@
 
 #include "CodePoint.hpp"
 
+#include <cstddef>
 #include <vector>
 
 namespace regex
@@ -10,8 +11,16 @@ namespace regex
 
 using Alphabet = std::vector<CodePointInterval>;
 
-bool isSubset(CodePointInterval inner, CodePointInterval outer);
+// Splits the intervals at every endpoint into sorted and disjoint intervals
+// covering min to max
 void disjoinOverlap(Alphabet& alphabet, CodePoint min, CodePoint max);
-void negate(Alphabet& alphabet);
+void negate(Alphabet& alphabet, CodePoint min, CodePoint max);
+
+// Sorts the intervals and merges those that overlap or are adjacent
+void merge(Alphabet& alphabet);
+
+// Binary searches the sorted and disjoint alphabet for the index of the
+// interval containing the code point. The code point shall be covered.
+std::size_t findInterval(const Alphabet& alphabet, CodePoint codePoint);
 
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// SSSE3 is not part of the x86-64 baseline. Kernels using it are compiled
+// with a target attribute and only run where the CPU supports it.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define REGEX_SSSE3_KERNELS
+#endif
+
+namespace regex
+{
+
+#if defined(REGEX_SSSE3_KERNELS)
+inline bool hasSsse3()
+{
+    static const bool kHasSsse3 = __builtin_cpu_supports("ssse3");
+    return kHasSsse3;
+}
+#endif
+
+// Up to three bytes searched for at once
+struct ByteSet
+{
+    static constexpr std::size_t kCapacity = 3;
+
+    std::array<unsigned char, kCapacity> Bytes{};
+    std::size_t Count{ 0 };
+};
+
+// Returns the index of the first byte of haystack at or after from that is in
+// the set, or the size of haystack if there is none. A single byte is found
+// with memchr. Two or three bytes are compared against 16 bytes of the
+// haystack at a time where SSE2 is available. Inline, so that callers in a
+// matching loop can keep the state of their automaton in registers.
+inline std::size_t findAnyByte(std::string_view haystack,
+                               std::size_t from,
+                               const ByteSet& set)
+{
+    if (from >= haystack.size() || set.Count == 0)
+    {
+        return haystack.size();
+    }
+
+    if (set.Count == 1)
+    {
+        const auto* hit = std::memchr(
+          haystack.data() + from, set.Bytes[0], haystack.size() - from);
+        return hit == nullptr
+                 ? haystack.size()
+                 : static_cast<std::size_t>(static_cast<const char*>(hit) -
+                                            haystack.data());
+    }
+
+    auto index = from;
+
+#if defined(__SSE2__)
+    constexpr std::size_t kBlock = sizeof(__m128i);
+
+    // The last byte stands in for a missing third one
+    const auto first = _mm_set1_epi8(static_cast<char>(set.Bytes[0]));
+    const auto second = _mm_set1_epi8(static_cast<char>(set.Bytes[1]));
+    const auto third =
+      _mm_set1_epi8(static_cast<char>(set.Bytes[set.Count - 1]));
+
+    for (; index + kBlock <= haystack.size(); index += kBlock)
+    {
+        const auto block = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(haystack.data() + index));
+
+        const auto matches =
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first),
+                                    _mm_cmpeq_epi8(block, second)),
+                       _mm_cmpeq_epi8(block, third));
+
+        const auto mask =
+          static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+
+    for (; index < haystack.size(); ++index)
+    {
+        const auto byte = static_cast<unsigned char>(haystack[index]);
+        if (byte == set.Bytes[0] || byte == set.Bytes[1] ||
+            byte == set.Bytes[set.Count - 1])
+        {
+            return index;
+        }
+    }
+
+    return index;
+}
+
+// Two bytes of a literal and their offsets into it
+struct BytePair
+{
+    std::array<unsigned char, 2> Bytes{};
+    std::array<std::size_t, 2> Offsets{};
+};
+
+// Returns the first start from from to last at which the haystack holds both
+// bytes of the pair at their offsets, or last + 1 if there is none. The
+// haystack shall hold last plus either offset. 16 starts are checked at a
+// time where SSE2 is available, which skips most starts that share only one
+// of the bytes. The rest are found with memchr for the first byte.
+inline std::size_t findBytePair(std::string_view haystack,
+                                std::size_t from,
+                                std::size_t last,
+                                const BytePair& pair)
+{
+    const auto* const data = haystack.data();
+    auto start = from;
+
+#if defined(__SSE2__)
+    constexpr std::size_t kBlock = sizeof(__m128i);
+
+    const auto first = _mm_set1_epi8(static_cast<char>(pair.Bytes[0]));
+    const auto second = _mm_set1_epi8(static_cast<char>(pair.Bytes[1]));
+
+    for (; start + kBlock - 1 <= last; start += kBlock)
+    {
+        const auto firstBlock = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(data + start + pair.Offsets[0]));
+        const auto secondBlock = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(data + start + pair.Offsets[1]));
+
+        const auto matches =
+          _mm_and_si128(_mm_cmpeq_epi8(firstBlock, first),
+                        _mm_cmpeq_epi8(secondBlock, second));
+
+        const auto mask =
+          static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        if (mask != 0)
+        {
+            return start + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+
+    while (start <= last)
+    {
+        const auto* hit = static_cast<const char*>(
+          std::memchr(data + start + pair.Offsets[0],
+                      pair.Bytes[0],
+                      last - start + 1));
+        if (hit == nullptr)
+        {
+            break;
+        }
+
+        start = static_cast<std::size_t>(hit - data) - pair.Offsets[0];
+        if (static_cast<unsigned char>(data[start + pair.Offsets[1]]) ==
+            pair.Bytes[1])
+        {
+            return start;
+        }
+        ++start;
+    }
+
+    return last + 1;
+}
+
+} // namespace regex
@@ -0,0 +1,155 @@
+#include "ClassRun.hpp"
+
+#include "ByteSearch.hpp"
+
+#if defined(REGEX_SSSE3_KERNELS)
+#include <tmmintrin.h>
+#endif
+
+namespace regex
+{
+
+namespace
+{
+
+constexpr CodePoint kAsciiMax = 0x7F;
+
+#if defined(REGEX_SSSE3_KERNELS)
+
+__attribute__((target("ssse3"))) std::size_t
+findNonMemberInBlocks(std::string_view target,
+                      const uint8_t* low,
+                      const uint8_t* high)
+{
+    constexpr std::size_t kBlock = sizeof(__m128i);
+
+    const auto lowTable =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(low));
+    const auto highTable =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(high));
+    const auto nibbleMask = _mm_set1_epi8(0x0F);
+    const auto zero = _mm_setzero_si128();
+
+    std::size_t index = 0;
+    for (; index + kBlock <= target.size(); index += kBlock)
+    {
+        const auto block = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(target.data() + index));
+
+        // Bytes beyond ASCII have a high nibble without a bit
+        const auto lows =
+          _mm_shuffle_epi8(lowTable, _mm_and_si128(block, nibbleMask));
+        const auto highs = _mm_shuffle_epi8(
+          highTable, _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask));
+        const auto nonMembers =
+          _mm_cmpeq_epi8(_mm_and_si128(lows, highs), zero);
+
+        const auto mask =
+          static_cast<unsigned int>(_mm_movemask_epi8(nonMembers));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+
+    return index;
+}
+
+#endif
+
+} // namespace
+
+ClassRun::ClassRun(ast::Slice<CodePointInterval> intervals,
+                   uint64_t min,
+                   uint64_t max,
+                   bool isMaxBounded)
+  : mMin{ min }
+  , mMax{ max }
+  , mIsMaxBounded{ isMaxBounded }
+{
+    for (const auto& [first, last] : intervals)
+    {
+        for (auto cp = first; cp <= std::min(last, kAsciiMax); ++cp)
+        {
+            mLow[cp % kNibbles] |= static_cast<uint8_t>(1U << (cp / kNibbles));
+        }
+    }
+
+    for (std::size_t high = 0; high <= kAsciiMax / kNibbles; ++high)
+    {
+        mHigh[high] = static_cast<uint8_t>(1U << high);
+    }
+}
+
+std::size_t ClassRun::findNonMember(std::string_view target) const
+{
+    std::size_t index = 0;
+
+#if defined(REGEX_SSSE3_KERNELS)
+    if (hasSsse3())
+    {
+        index = findNonMemberInBlocks(target, mLow.data(), mHigh.data());
+    }
+#endif
+
+    for (; index < target.size(); ++index)
+    {
+        const auto byte = static_cast<unsigned char>(target[index]);
+        if ((mLow[byte % kNibbles] & mHigh[byte / kNibbles]) == 0)
+        {
+            break;
+        }
+    }
+
+    return index;
+}
+
+ClassRun::Verdict ClassRun::match(std::string_view target) const
+{
+    const auto end = findNonMember(target);
+    if (end < target.size())
+    {
+        // Characters beyond ASCII may still be members
+        return static_cast<unsigned char>(target[end]) > kAsciiMax
+                 ? Verdict::eUnknown
+                 : Verdict::eNoMatch;
+    }
+
+    // Every byte is a character
+    const auto count = static_cast<uint64_t>(target.size());
+    return count >= mMin && (!mIsMaxBounded || count <= mMax)
+             ? Verdict::eMatch
+             : Verdict::eNoMatch;
+}
+
+std::optional<ClassRun> findClassRun(const ast::AST& ast)
+{
+    const auto* node = &ast[ast.root()];
+    uint64_t min = 1;
+    uint64_t max = 1;
+    bool isMaxBounded = true;
+
+    if (node->Kind == ast::NodeKind::eQuantifier)
+    {
+        min = node->Min;
+        max = node->Max;
+        isMaxBounded = node->IsMaxBounded;
+        node = &ast[node->Inner];
+    }
+
+    if (node->Kind != ast::NodeKind::eCharacterClass)
+    {
+        return std::nullopt;
+    }
+
+    const auto intervals = ast.intervals(*node);
+    if (intervals.begin() == intervals.end() ||
+        intervals.begin()->first > kAsciiMax)
+    {
+        return std::nullopt;
+    }
+
+    return ClassRun(intervals, min, max, isMaxBounded);
+}
+
+} // namespace regex
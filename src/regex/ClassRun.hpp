@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AST.hpp"
+#include "CodePoint.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace regex
+{
+
+// Matches patterns that are one character class repeated, such as [0-9]+ or
+// [A-Za-z0-9_-]{1,64}, without the automaton. The ASCII members of the class
+// are kept as two tables indexed by the low and the high nibble of a byte,
+// so the membership of 16 bytes is checked with two shuffles (pshufb). A
+// target with characters beyond ASCII is left to the automaton.
+class ClassRun
+{
+public:
+    enum class Verdict
+    {
+        eMatch,
+        eNoMatch,
+
+        // The target has a character beyond ASCII
+        eUnknown
+    };
+
+    ClassRun(ast::Slice<CodePointInterval> intervals,
+             uint64_t min,
+             uint64_t max,
+             bool isMaxBounded);
+
+    [[nodiscard]] Verdict match(std::string_view target) const;
+
+private:
+    static constexpr std::size_t kNibbles = 16;
+    using NibbleTable = std::array<uint8_t, kNibbles>;
+
+    // The index of the first byte that is not an ASCII member
+    [[nodiscard]] std::size_t findNonMember(std::string_view target) const;
+
+    // Bit h of entry l is set if the character 16 * h + l is a member.
+    // Entry h of the high table is bit h, or 0 beyond ASCII.
+    NibbleTable mLow{};
+    NibbleTable mHigh{};
+
+    uint64_t mMin;
+    uint64_t mMax;
+    bool mIsMaxBounded;
+};
+
+// The class run the AST consists of, if any. Classes without ASCII members
+// are not worth one.
+[[nodiscard]] std::optional<ClassRun> findClassRun(const ast::AST& ast);
+
+} // namespace regex
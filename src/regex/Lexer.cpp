@@ -0,0 +1,572 @@
+#include "Lexer.hpp"
+
+#include "Alphabet.hpp"
+#include "Utf8Iterator.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace regex::parser
+{
+
+namespace
+{
+
+std::u32string decode(const std::string& pattern, Mode mode)
+{
+    std::u32string decoded;
+
+    if (mode == Mode::eBytes)
+    {
+        for (const auto byte : pattern)
+        {
+            decoded.push_back(static_cast<unsigned char>(byte));
+        }
+        return decoded;
+    }
+
+    // NOLINTNEXTLINE(modernize-loop-convert)
+    for (Utf8Iterator it = pattern.cbegin(); it != pattern.cend(); ++it)
+    {
+        decoded.push_back(*it);
+    }
+    return decoded;
+}
+
+bool isDigit(CodePoint cp)
+{
+    return cp >= '0' && cp <= '9';
+}
+
+bool isShorthand(CodePoint cp)
+{
+    return cp == 'w' || cp == 'W' || cp == 'd' || cp == 'D' || cp == 's' ||
+           cp == 'S';
+}
+
+CodePoint hex2int(CodePoint ch)
+{
+    CodePoint val{};
+    if (ch >= '0' && ch <= '9')
+    {
+        val = ch - '0';
+    }
+    else if (ch >= 'A' && ch <= 'F')
+    {
+        val = ch - 'A' + 10;
+    }
+    else if (ch >= 'a' && ch <= 'f')
+    {
+        val = ch - 'a' + 10;
+    }
+    else
+    {
+        val = kInvalid;
+    }
+    return val;
+}
+
+} // namespace
+
+Lexer::Lexer(const std::string& pattern, Mode mode)
+  : mPattern{ decode(pattern, mode) }
+  , mCodePointMax{ mode == Mode::eBytes ? kByteMax : kCodePointMax }
+{
+}
+
+CodePoint Lexer::codePointMax() const
+{
+    return mCodePointMax;
+}
+
+void Lexer::error(const std::string& msg) const
+{
+    error(msg, mCursor);
+}
+
+void Lexer::error(const std::string& msg, std::size_t position)
+{
+    throw std::runtime_error("Error at position " + std::to_string(position) +
+                             ". Message: " + msg);
+}
+
+CodePoint Lexer::peek(std::size_t offset) const
+{
+    const auto index = mCursor + offset;
+    return (index < mPattern.size() ? mPattern[index] : kEOF);
+}
+
+CodePoint Lexer::get()
+{
+    return (mCursor < mPattern.size() ? mPattern[mCursor++] : kEOF);
+}
+
+Token Lexer::next()
+{
+    Token token;
+    token.Position = mCursor;
+
+    const auto cp = get();
+    switch (cp)
+    {
+        case kEOF:
+        {
+            token.Kind = TokenKind::eEOF;
+            break;
+        }
+        case '(':
+        {
+            if (peek() == '?' && peek(1) == ':')
+            {
+                mCursor += 2;
+                error("Non-capturing groups are the default. Capturing "
+                      "groups not supported");
+            }
+            token.Kind = TokenKind::eGroupOpen;
+            break;
+        }
+        case ')':
+        {
+            token.Kind = TokenKind::eGroupClose;
+            break;
+        }
+        case '|':
+        {
+            token.Kind = TokenKind::eAlternative;
+            break;
+        }
+        case '^':
+        case '$':
+        {
+            error("Anchors are not supported ");
+        }
+        case '.':
+        {
+            token.Kind = TokenKind::eAnyCharacter;
+            token.Group = { { kCodePointMin, '\n' - 1 },
+                            { '\n' + 1, mCodePointMax } };
+            break;
+        }
+        case '[':
+        {
+            lexCharacterClass(token);
+            break;
+        }
+        case ']':
+        {
+            token.Kind = TokenKind::eCharacterClassClose;
+            break;
+        }
+        case '*':
+        case '+':
+        case '?':
+        {
+            token.Kind = TokenKind::eQuantifier;
+            token.Min = (cp == '+') ? 1 : 0;
+            token.Max = (cp == '?') ? 1 : 0;
+            token.IsMaxBounded = (cp == '?');
+            lexLazyModifier();
+            break;
+        }
+        case '{':
+        {
+            // A '{' is a literal unless it starts a ranged quantifier
+            if (lexRangeQuantifier(token))
+            {
+                lexLazyModifier();
+                break;
+            }
+            token.Kind = TokenKind::eCharacter;
+            token.Character = cp;
+            break;
+        }
+        case '\\':
+        {
+            lexEscape(token);
+            break;
+        }
+        default:
+        {
+            token.Kind = TokenKind::eCharacter;
+            token.Character = cp;
+            break;
+        }
+    }
+
+    return token;
+}
+
+void Lexer::lexEscape(Token& token)
+{
+    const auto cp = peek();
+
+    if (isDigit(cp))
+    {
+        uint64_t integer = 0;
+        bool overflow = false;
+        lexInteger(integer, overflow);
+
+        if (overflow)
+        {
+            error("back reference is too large");
+        }
+        error("Backreferences are not supported");
+    }
+
+    if (cp == kEOF)
+    {
+        error("Pattern may not end with a trailing backslash");
+    }
+
+    if (isShorthand(cp))
+    {
+        get();
+        token.Kind = TokenKind::eCharacterClass;
+        addShorthand(cp, token.Group);
+        return;
+    }
+
+    token.Kind = TokenKind::eCharacter;
+    token.Character = lexEscapedCharacter(get());
+}
+
+CodePoint Lexer::lexEscapedCharacter(CodePoint cp)
+{
+    switch (cp)
+    {
+        case '^':
+        case '$':
+        case '*':
+        case '+':
+        case '?':
+        case '.':
+        case '|':
+        case '(':
+        case ')':
+        case '[':
+        case ']':
+        case '-':
+        {
+            return cp;
+        }
+        case 'n':
+        {
+            return '\n';
+        }
+        case 'f':
+        {
+            return '\f';
+        }
+        case 'r':
+        {
+            return '\r';
+        }
+        case 't':
+        {
+            return '\t';
+        }
+        case 'v':
+        {
+            return '\v';
+        }
+        case 'a':
+        {
+            return '\a';
+        }
+        case '\\':
+        {
+            return '\\';
+        }
+        case 'u':
+        {
+            return lexHexadecimal(4, "The Unicode codepoint is incomplete");
+        }
+        case 'U':
+        {
+            const auto codePoint =
+              lexHexadecimal(8, "The Unicode codepoint is incomplete");
+            return codePoint;
+        }
+        case 'x':
+        {
+            return lexHexadecimal(2,
+                                  "The hexadecimal codepoint is incomplete");
+        }
+        default:
+        {
+            error("This token has no special meaning and has thus been "
+                  "rendered erroneous");
+        }
+    }
+}
+
+CodePoint Lexer::lexHexadecimal(unsigned int digitCount,
+                                const char* incomplete)
+{
+    CodePoint cp = 0;
+    for (auto i = 0U; i < digitCount; ++i)
+    {
+        CodePoint digit = hex2int(get());
+        if (digit == kInvalid)
+        {
+            error(incomplete);
+        }
+
+        cp = cp << 4;
+        cp |= digit;
+    }
+
+    if (cp > kCodePointMax)
+    {
+        error("The Unicode codepoint invalid");
+    }
+
+    if (cp > mCodePointMax)
+    {
+        error("The codepoint exceeds the byte range");
+    }
+
+    return cp;
+}
+
+void Lexer::lexCharacterClass(Token& token)
+{
+    token.Kind = TokenKind::eCharacterClass;
+    auto& group = token.Group;
+
+    const bool negated = (peek() == '^');
+    if (negated)
+    {
+        get();
+    }
+
+    // A leading ']' is taken literally
+    if (peek() == ']')
+    {
+        get();
+        group.emplace_back(']', ']');
+    }
+
+    while (true)
+    {
+        if (peek() == '\\' && isShorthand(peek(1)))
+        {
+            get();
+            addShorthand(get(), group);
+            continue;
+        }
+
+        CodePoint start{};
+        if (!lexClassCharacter(start))
+        {
+            break;
+        }
+
+        // A '-' before the closing bracket is taken literally
+        if (peek() == '-' && peek(1) != ']' && peek(1) != kEOF)
+        {
+            get();
+
+            CodePoint end{};
+            lexClassCharacter(end);
+
+            if (start > end)
+            {
+                error("Character range is out of order");
+            }
+
+            group.emplace_back(start, end);
+            continue;
+        }
+
+        group.emplace_back(start, start);
+    }
+
+    if (get() != ']')
+    {
+        error("Character class missing closing bracket");
+    }
+
+    if (negated)
+    {
+        negate(group, kCodePointMin, mCodePointMax);
+    }
+}
+
+bool Lexer::lexClassCharacter(CodePoint& cp)
+{
+    // While '-' and '[' and '^' are meta-characters, they may be
+    // interpreted literally depending on their position in the
+    // character class. Hence, only ']' ends the class.
+    const auto next = peek();
+    if (next == kEOF || next == ']')
+    {
+        return false;
+    }
+    get();
+
+    if (next != '\\')
+    {
+        cp = next;
+        return true;
+    }
+
+    const auto escaped = peek();
+    if (escaped == kEOF)
+    {
+        error("Pattern may not end with a trailing backslash");
+    }
+
+    // Shorthands cannot end a range, the backslash is taken literally
+    if (isShorthand(escaped))
+    {
+        cp = '\\';
+        return true;
+    }
+
+    cp = lexEscapedCharacter(get());
+    return true;
+}
+
+bool Lexer::lexRangeQuantifier(Token& token)
+{
+    const auto begin = mCursor;
+
+    uint64_t min = 0;
+    uint64_t max = 0;
+    bool isMaxBounded = true;
+    bool minOverflow = false;
+    bool maxOverflow = false;
+
+    if (!lexInteger(min, minOverflow))
+    {
+        mCursor = begin;
+        return false;
+    }
+
+    max = min;
+
+    if (peek() == ',')
+    {
+        get();
+        if (!lexInteger(max, maxOverflow))
+        {
+            isMaxBounded = false;
+        }
+    }
+
+    if (peek() != '}')
+    {
+        mCursor = begin;
+        return false;
+    }
+    get();
+
+    if (minOverflow)
+    {
+        error("Lower bound on ranged quantifier too large");
+    }
+
+    if (maxOverflow)
+    {
+        error("Upper bound on ranged quantifier too large");
+    }
+
+    if (min > max && isMaxBounded)
+    {
+        error("The quantifier range is out of order");
+    }
+
+    token.Kind = TokenKind::eQuantifier;
+    token.Min = min;
+    token.Max = max;
+    token.IsMaxBounded = isMaxBounded;
+    return true;
+}
+
+bool Lexer::lexInteger(uint64_t& integer, bool& overflow)
+{
+    integer = 0;
+    overflow = false;
+
+    if (!isDigit(peek()))
+    {
+        return false;
+    }
+
+    while (isDigit(peek()))
+    {
+        integer *= 10;
+        integer += get() - '0';
+
+        if (integer > std::numeric_limits<uint32_t>::max())
+        {
+            overflow = true;
+        }
+    }
+
+    return true;
+}
+
+void Lexer::lexLazyModifier()
+{
+    if (peek() == '?')
+    {
+        get();
+        error("Lazy modifier is not supported ");
+    }
+}
+
+void Lexer::addShorthand(CodePoint letter, CharacterGroup& group) const
+{
+    switch (letter)
+    {
+        case 'w':
+        {
+            group.emplace_back(0x30, 0x39);
+            group.emplace_back(0x41, 0x5A);
+            group.emplace_back(0x5F, 0x5F);
+            group.emplace_back(0x61, 0x7A);
+            break;
+        }
+        case 'W':
+        {
+            group.emplace_back(kCodePointMin, 0x2F);
+            group.emplace_back(0x3A, 0x40);
+            group.emplace_back(0x5B, 0x5E);
+            group.emplace_back(0x60, 0x60);
+            group.emplace_back(0x7B, mCodePointMax);
+            break;
+        }
+        case 'd':
+        {
+            group.emplace_back(0x30, 0x39);
+            break;
+        }
+        case 'D':
+        {
+            group.emplace_back(kCodePointMin, 0x2F);
+            group.emplace_back(0x3A, mCodePointMax);
+            break;
+        }
+        case 's':
+        {
+            group.emplace_back(0x09, 0x0D);
+            group.emplace_back(0x20, 0x20);
+            break;
+        }
+        case 'S':
+        {
+            group.emplace_back(kCodePointMin, 0x08);
+            group.emplace_back(0x0E, 0x1F);
+            group.emplace_back(0x21, mCodePointMax);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+} // namespace regex::parser
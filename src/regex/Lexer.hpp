@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CodePoint.hpp"
+
+#include <regex/Regex.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace regex::parser
+{
+
+using CharacterGroup = std::vector<CodePointInterval>;
+
+enum class TokenKind
+{
+    eCharacter,
+    eAnyCharacter,
+    eCharacterClass,
+    eQuantifier,
+    eAlternative,
+    eGroupOpen,
+    eGroupClose,
+    eCharacterClassClose,
+    eEOF
+};
+
+struct Token
+{
+    TokenKind Kind{ TokenKind::eEOF };
+
+    // The offset of the token's first character in the decoded pattern
+    std::size_t Position{};
+
+    // eCharacter
+    CodePoint Character{};
+
+    // eAnyCharacter and eCharacterClass
+    CharacterGroup Group;
+
+    // eQuantifier
+    uint64_t Min{};
+    uint64_t Max{};
+    bool IsMaxBounded{};
+};
+
+// Splits a pattern into tokens in a single left to right pass. Tokens are
+// lexed on demand, so errors are reported in the order they appear in the
+// pattern. Character classes and ranged quantifiers are lexed as a whole
+// since their contents follow their own rules.
+class Lexer
+{
+public:
+    Lexer(const std::string& pattern, Mode mode);
+
+    Token next();
+
+    [[nodiscard]] CodePoint codePointMax() const;
+
+    // Reports an error after the most recently lexed character
+    [[noreturn]] void error(const std::string& msg) const;
+
+    [[noreturn]] static void error(const std::string& msg,
+                                   std::size_t position);
+
+private:
+    [[nodiscard]] CodePoint peek(std::size_t offset = 0) const;
+    CodePoint get();
+
+    void lexEscape(Token& token);
+    void lexCharacterClass(Token& token);
+    bool lexClassCharacter(CodePoint& cp);
+    bool lexRangeQuantifier(Token& token);
+    bool lexInteger(uint64_t& integer, bool& overflow);
+    void lexLazyModifier();
+    CodePoint lexEscapedCharacter(CodePoint cp);
+    CodePoint lexHexadecimal(unsigned int digitCount, const char* incomplete);
+    void addShorthand(CodePoint letter, CharacterGroup& group) const;
+
+    // The pattern is decoded once up front
+    const std::u32string mPattern;
+    std::size_t mCursor{ 0 };
+    const CodePoint mCodePointMax;
+};
+
+} // namespace regex::parser
@@ -0,0 +1,94 @@
+#include "LiteralMatcher.hpp"
+
+#include "CodePoint.hpp"
+#include "Prefilter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace regex
+{
+
+namespace
+{
+
+// In byte mode every code point is below 0x100 and one code unit
+std::u16string encodeUtf16(const std::u32string& literal)
+{
+    constexpr char32_t kSurrogateBase = 0x10000;
+    constexpr char32_t kHighSurrogate = 0xD800;
+    constexpr char32_t kLowSurrogate = 0xDC00;
+
+    std::u16string encoded;
+
+    for (const auto cp : literal)
+    {
+        if (cp < kSurrogateBase)
+        {
+            encoded += static_cast<char16_t>(cp);
+            continue;
+        }
+
+        const auto offset = cp - kSurrogateBase;
+        encoded += static_cast<char16_t>(kHighSurrogate + (offset >> 10));
+        encoded += static_cast<char16_t>(kLowSurrogate + (offset & 0x3FF));
+    }
+
+    return encoded;
+}
+
+} // namespace
+
+LiteralMatcher::LiteralMatcher(const std::u32string& literal, Mode mode)
+  : mMode{ mode }
+  , mBytes{ encodeLiteral(literal, mode) }
+  , mUtf16{ encodeUtf16(literal) }
+  , mUtf32{ literal }
+  , mRare{ findRarestByte(mBytes) }
+{
+}
+
+template<typename String>
+bool LiteralMatcher::isSearchable(const String& target) const
+{
+    // Surrogates are above 0xFF too
+    return mMode != Mode::eBytes ||
+           std::all_of(target.begin(),
+                       target.end(),
+                       [](auto unit) { return unit <= kByteMax; });
+}
+
+bool LiteralMatcher::match(const std::string& target) const
+{
+    return target.size() == mBytes.size() &&
+           std::memcmp(target.data(), mBytes.data(), mBytes.size()) == 0;
+}
+
+bool LiteralMatcher::match(const std::u16string& target) const
+{
+    return target == mUtf16;
+}
+
+bool LiteralMatcher::match(const std::u32string& target) const
+{
+    return target == mUtf32;
+}
+
+bool LiteralMatcher::search(const std::string& target) const
+{
+    return findLiteral(target, mBytes, mRare) != std::string_view::npos;
+}
+
+bool LiteralMatcher::search(const std::u16string& target) const
+{
+    return isSearchable(target) &&
+           target.find(mUtf16) != std::u16string::npos;
+}
+
+bool LiteralMatcher::search(const std::u32string& target) const
+{
+    return isSearchable(target) &&
+           target.find(mUtf32) != std::u32string::npos;
+}
+
+} // namespace regex
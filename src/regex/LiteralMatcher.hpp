@@ -0,0 +1,42 @@
+#pragma once
+
+#include <regex/Regex.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace regex
+{
+
+// Matches a pattern that is a plain literal without building an automaton.
+// Whole targets are compared with memcmp, parts of them are found with
+// findLiteral.
+class LiteralMatcher
+{
+public:
+    LiteralMatcher(const std::u32string& literal, Mode mode);
+
+    [[nodiscard]] bool match(const std::string& target) const;
+    [[nodiscard]] bool match(const std::u16string& target) const;
+    [[nodiscard]] bool match(const std::u32string& target) const;
+    [[nodiscard]] bool search(const std::string& target) const;
+    [[nodiscard]] bool search(const std::u16string& target) const;
+    [[nodiscard]] bool search(const std::u32string& target) const;
+
+private:
+    // In byte mode, targets with code points above 0xFF are never found
+    template<typename String>
+    [[nodiscard]] bool isSearchable(const String& target) const;
+
+    Mode mMode;
+
+    // The literal encoded like the targets of each overload
+    std::string mBytes;
+    std::u16string mUtf16;
+    std::u32string mUtf32;
+
+    // The byte of mBytes findLiteral scans for
+    std::size_t mRare;
+};
+
+} // namespace regex
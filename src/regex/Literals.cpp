@@ -0,0 +1,435 @@
+#include "Literals.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace regex::ast
+{
+
+namespace
+{
+
+std::u32string head(std::u32string literal)
+{
+    literal.resize(std::min(literal.size(), kMaxLiteralLength));
+    return literal;
+}
+
+std::u32string tail(const std::u32string& literal)
+{
+    const auto length = std::min(literal.size(), kMaxLiteralLength);
+    return literal.substr(literal.size() - length);
+}
+
+using Length = std::optional<uint64_t>;
+
+// Longer matches count as unbounded, so that lengths cannot overflow
+constexpr uint64_t kMaxLength = uint64_t{ 1 } << 32;
+
+Length add(Length lhs, Length rhs)
+{
+    if (!lhs || !rhs || *lhs + *rhs > kMaxLength)
+    {
+        return std::nullopt;
+    }
+    return *lhs + *rhs;
+}
+
+Length multiply(Length length, uint64_t count)
+{
+    if (!length || (count != 0 && *length > kMaxLength / count))
+    {
+        return std::nullopt;
+    }
+    return *length * count;
+}
+
+Length longer(Length lhs, Length rhs)
+{
+    if (!lhs || !rhs)
+    {
+        return std::nullopt;
+    }
+    return std::max(*lhs, *rhs);
+}
+
+// How far into a match the suffix starts at most
+Length findSuffixOffset(const Literals& literals)
+{
+    if (!literals.MaxLength)
+    {
+        return std::nullopt;
+    }
+    return *literals.MaxLength -
+           std::min<uint64_t>(*literals.MaxLength, literals.Suffix.size());
+}
+
+// The length of the shortest literal, which bounds how selective a set is.
+// 0 for the empty set.
+std::size_t shortest(const std::vector<std::u32string>& literals)
+{
+    if (literals.empty())
+    {
+        return 0;
+    }
+
+    return std::min_element(literals.begin(),
+                            literals.end(),
+                            [](const auto& lhs, const auto& rhs)
+                            { return lhs.size() < rhs.size(); })
+      ->size();
+}
+
+// Exact literals longer than the limit keep their ends only
+Literals makeExact(const std::u32string& literal)
+{
+    if (literal.size() > kMaxLiteralLength)
+    {
+        const auto prefix = head(literal);
+        return Literals{
+            prefix, tail(literal), prefix, {}, false, false, literal.size(), 0
+        };
+    }
+
+    return Literals{ literal, literal, literal, {},
+                     true,    false,   literal.size(), 0 };
+}
+
+// The set with the longer shortest literal, the first one on a tie
+std::vector<std::u32string>
+mostSelective(const std::vector<std::u32string>& lhs,
+              const std::vector<std::u32string>& rhs)
+{
+    return shortest(rhs) > shortest(lhs) ? rhs : lhs;
+}
+
+void insert(std::vector<std::u32string>& literals, std::u32string literal)
+{
+    if (std::find(literals.begin(), literals.end(), literal) == literals.end())
+    {
+        literals.push_back(std::move(literal));
+    }
+}
+
+// Every literal of lhs followed by every literal of rhs, or none if there
+// would be too many
+std::vector<std::u32string> combine(const std::vector<std::u32string>& lhs,
+                                    const std::vector<std::u32string>& rhs)
+{
+    std::vector<std::u32string> literals;
+    if (lhs.size() * rhs.size() > kMaxRequiredAny)
+    {
+        return literals;
+    }
+
+    for (const auto& left : lhs)
+    {
+        for (const auto& right : rhs)
+        {
+            insert(literals, head(left + right));
+        }
+    }
+
+    return literals;
+}
+
+// The literals matched if nothing else is
+std::optional<std::vector<std::u32string>> exactLiterals(
+  const Literals& literals)
+{
+    if (literals.IsExact)
+    {
+        return std::vector{ literals.Prefix };
+    }
+
+    if (literals.IsExactAny)
+    {
+        return literals.RequiredAny;
+    }
+
+    return std::nullopt;
+}
+
+// One literal of every alternative is required, as long as every
+// alternative requires one and there are not too many
+std::vector<std::u32string>
+requireAny(const std::vector<const Literals*>& alternatives)
+{
+    std::vector<std::u32string> literals;
+
+    for (const auto* alternative : alternatives)
+    {
+        const auto required = mostSelective(alternative->RequiredAny,
+                                            { alternative->Required });
+        if (shortest(required) == 0)
+        {
+            return {};
+        }
+
+        for (const auto& literal : required)
+        {
+            insert(literals, literal);
+        }
+
+        if (literals.size() > kMaxRequiredAny)
+        {
+            return {};
+        }
+    }
+
+    return literals;
+}
+
+Literals concatenate(const Literals& lhs, const Literals& rhs)
+{
+    if (lhs.IsExact && rhs.IsExact)
+    {
+        return makeExact(lhs.Prefix + rhs.Prefix);
+    }
+
+    auto result = Literals{};
+    result.Prefix = lhs.IsExact ? head(lhs.Prefix + rhs.Prefix) : lhs.Prefix;
+    result.Suffix = rhs.IsExact ? tail(lhs.Suffix + rhs.Suffix) : rhs.Suffix;
+
+    result.MaxLength = add(lhs.MaxLength, rhs.MaxLength);
+
+    // The longest required literal of either side. A factor may also span
+    // the boundary of both sides, it starts with the suffix of the left one.
+    result.Required = lhs.Required;
+    result.RequiredOffset = lhs.RequiredOffset;
+    if (rhs.Required.size() > result.Required.size())
+    {
+        result.Required = rhs.Required;
+        result.RequiredOffset = add(lhs.MaxLength, rhs.RequiredOffset);
+    }
+
+    const auto spanning = head(lhs.Suffix + rhs.Prefix);
+    if (spanning.size() > result.Required.size())
+    {
+        result.Required = spanning;
+        result.RequiredOffset = findSuffixOffset(lhs);
+    }
+
+    // The literals of an exact side are followed by the prefix or preceded
+    // by the suffix of the other side
+    const auto lhsExact = exactLiterals(lhs);
+    const auto rhsExact = exactLiterals(rhs);
+    auto spanningAny = std::vector<std::u32string>{};
+    if (lhsExact)
+    {
+        spanningAny = combine(*lhsExact, rhsExact ? *rhsExact
+                                                  : std::vector{ rhs.Prefix });
+    }
+    else if (rhsExact)
+    {
+        spanningAny = combine({ lhs.Suffix }, *rhsExact);
+    }
+
+    // Literals as long as the limit may have been cut
+    result.IsExactAny =
+      lhsExact && rhsExact && !spanningAny.empty() &&
+      std::none_of(spanningAny.begin(),
+                   spanningAny.end(),
+                   [](const auto& literal)
+                   { return literal.size() >= kMaxLiteralLength; });
+    result.RequiredAny = mostSelective(
+      spanningAny, mostSelective(lhs.RequiredAny, rhs.RequiredAny));
+    return result;
+}
+
+Literals alternate(const std::vector<const Literals*>& alternatives)
+{
+    const auto& first = *alternatives.front();
+    const auto isSame = [&first](const Literals* literals)
+    { return literals->IsExact && literals->Prefix == first.Prefix; };
+
+    if (first.IsExact &&
+        std::all_of(alternatives.begin(), alternatives.end(), isSame))
+    {
+        return first;
+    }
+
+    auto result = first;
+    result.IsExact = false;
+    result.IsExactAny = false;
+
+    for (const auto* literals : alternatives)
+    {
+        const auto prefixLength = static_cast<std::size_t>(
+          std::mismatch(result.Prefix.begin(),
+                        result.Prefix.end(),
+                        literals->Prefix.begin(),
+                        literals->Prefix.end())
+            .first -
+          result.Prefix.begin());
+        result.Prefix.resize(prefixLength);
+
+        const auto suffixLength = static_cast<std::size_t>(
+          std::mismatch(result.Suffix.rbegin(),
+                        result.Suffix.rend(),
+                        literals->Suffix.rbegin(),
+                        literals->Suffix.rend())
+            .first -
+          result.Suffix.rbegin());
+        result.Suffix = result.Suffix.substr(result.Suffix.size() -
+                                             suffixLength);
+
+        if (literals->Required != result.Required)
+        {
+            result.Required.clear();
+        }
+
+        result.MaxLength = longer(result.MaxLength, literals->MaxLength);
+        result.RequiredOffset =
+          longer(result.RequiredOffset, literals->RequiredOffset);
+    }
+
+    // The prefix starts every match, the suffix ends it
+    if (result.Prefix.size() > result.Required.size())
+    {
+        result.Required = result.Prefix;
+        result.RequiredOffset = 0;
+    }
+
+    if (result.Suffix.size() > result.Required.size())
+    {
+        result.Required = result.Suffix;
+        result.RequiredOffset = findSuffixOffset(result);
+    }
+
+    // Alternatives that match their literals only are matched exactly by
+    // the literals of all of them
+    result.RequiredAny = requireAny(alternatives);
+    result.IsExactAny =
+      !result.RequiredAny.empty() &&
+      std::all_of(alternatives.begin(),
+                  alternatives.end(),
+                  [](const Literals* literals)
+                  { return literals->IsExact || literals->IsExactAny; });
+    return result;
+}
+
+Literals quantify(const Literals& inner, const Node& node)
+{
+    if (node.IsMaxBounded && node.Max == 0)
+    {
+        return makeExact({});
+    }
+
+    const auto maxLength = node.IsMaxBounded
+                             ? multiply(inner.MaxLength, node.Max)
+                             : std::nullopt;
+
+    if (node.Min == 0)
+    {
+        auto result = Literals{};
+        result.MaxLength = maxLength;
+        return result;
+    }
+
+    // The inner literal repeated as often as it is mandatory, capped by the
+    // length limit
+    auto repeated = std::u32string{};
+    for (uint64_t i = 0;
+         i < node.Min && repeated.size() <= kMaxLiteralLength;
+         ++i)
+    {
+        repeated += inner.Prefix;
+    }
+
+    if (inner.IsExact)
+    {
+        const auto isFixed = node.IsMaxBounded && node.Min == node.Max;
+        if (isFixed && (repeated.size() <= kMaxLiteralLength ||
+                        inner.Prefix.empty()))
+        {
+            return makeExact(repeated);
+        }
+
+        auto result = Literals{};
+        result.Prefix = head(repeated);
+        result.Suffix = tail(repeated);
+        result.Required = result.Prefix;
+        result.MaxLength = maxLength;
+        result.RequiredOffset = 0;
+        return result;
+    }
+
+    // Repetitions of a set of literals are not one of them. The first
+    // repetition has the required literal.
+    auto result = inner;
+    result.IsExactAny = false;
+    result.MaxLength = maxLength;
+    return result;
+}
+
+} // namespace
+
+Literals extractLiterals(const AST& ast)
+{
+    // Children are added before their parents, so visiting the nodes in
+    // order of their ids visits every node after its children
+    std::vector<Literals> literals(ast.size());
+
+    for (NodeId id = 0; id < ast.size(); ++id)
+    {
+        const auto& node = ast[id];
+
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            {
+                std::vector<const Literals*> alternatives;
+                for (const auto child : ast.children(node))
+                {
+                    alternatives.push_back(&literals[child]);
+                }
+                literals[id] = alternate(alternatives);
+                break;
+            }
+            case NodeKind::eConcatenation:
+            {
+                const auto children = ast.children(node);
+                auto result = literals[children[0]];
+                for (std::size_t i = 1; i < children.size(); ++i)
+                {
+                    result = concatenate(result, literals[children[i]]);
+                }
+                literals[id] = std::move(result);
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                literals[id] = quantify(literals[node.Inner], node);
+                break;
+            }
+            case NodeKind::eEpsilon:
+            {
+                literals[id] = makeExact({});
+                break;
+            }
+            case NodeKind::eNull:
+            {
+                literals[id].MaxLength = 0;
+                break;
+            }
+            case NodeKind::eCharacterClass:
+            {
+                const auto intervals = ast.intervals(node);
+                if (intervals.size() == 1 &&
+                    intervals[0].first == intervals[0].second)
+                {
+                    literals[id] = makeExact({ intervals[0].first });
+                }
+                literals[id].MaxLength = 1;
+                break;
+            }
+        }
+    }
+
+    return literals[ast.root()];
+}
+
+} // namespace regex::ast
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AST.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace regex::ast
+{
+
+// Literals found in every match of an AST. Empty literals are unknown.
+struct Literals
+{
+    // Every match starts with the prefix and ends with the suffix
+    std::u32string Prefix;
+    std::u32string Suffix;
+
+    // Every match contains the required literal. The longest one found.
+    std::u32string Required;
+
+    // Every match contains one of these literals, e.g. one of those of an
+    // alternation. At most kMaxRequiredAny. Selective only if the shortest of
+    // them is longer than the required literal.
+    std::vector<std::u32string> RequiredAny;
+
+    // The AST matches the prefix and nothing else
+    bool IsExact{ false };
+
+    // The AST matches the literals of RequiredAny and nothing else
+    bool IsExactAny{ false };
+
+    // The most code points of a match, unbounded if empty
+    std::optional<uint64_t> MaxLength{ std::nullopt };
+
+    // Every match has the required literal at most this many code points
+    // after its start. Unbounded if empty.
+    std::optional<uint64_t> RequiredOffset{ std::nullopt };
+};
+
+// Extracts the literals from the AST. Literals are cut to kMaxLiteralLength
+// code points, longer ones do not make a prefilter any more selective.
+[[nodiscard]] Literals extractLiterals(const AST& ast);
+
+constexpr std::size_t kMaxLiteralLength = 64;
+constexpr std::size_t kMaxRequiredAny = 32;
+
+} // namespace regex::ast
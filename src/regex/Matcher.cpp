@@ -0,0 +1,503 @@
+#include "Matcher.hpp"
+
+#include "Utf16Iterator.hpp"
+#include "Utf8Iterator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace regex
+{
+
+Matcher::Matcher(const ast::AST& ast, Mode mode, StartFinder findStart)
+  : mMode{ mode }
+  , mFindStart{ std::move(findStart) }
+  , mAlphabet{ ast.makeAlphabet() }
+  , mDFA{ mergeAlphabet(ast.makeNFA(mAlphabet).makeDFA()) }
+  , mByteClasses{ makeByteClasses(mDFA, mAlphabet, mInputs) }
+  , mEscapes{ accelerate() }
+  , mTable{ makeTable(mDFA, mEscapes.size() - mDFA.sinkCount()) }
+{
+}
+
+template<typename Class>
+bool Matcher::fitsClass(const DFA& dfa)
+{
+    return dfa.inputCount() <=
+           std::size_t{ std::numeric_limits<Class>::max() } + 1;
+}
+
+Matcher::Table Matcher::makeTable(const DFA& dfa, std::size_t acceleratedCount)
+{
+    if (fitsClass<uint8_t>(dfa))
+    {
+        return makeTable<uint8_t>(dfa, acceleratedCount);
+    }
+
+    if (fitsClass<uint16_t>(dfa))
+    {
+        return makeTable<uint16_t>(dfa, acceleratedCount);
+    }
+
+    throw std::runtime_error("The automaton of the pattern is too large");
+}
+
+template<typename Class>
+Matcher::Table Matcher::makeTable(const DFA& dfa, std::size_t acceleratedCount)
+{
+    const auto denseBytes = DFATable<uint16_t, Class>::fits(dfa)
+                              ? DFATable<uint16_t, Class>::bytes(dfa)
+                              : DFATable<uint32_t, Class>::bytes(dfa);
+
+    if (denseBytes > kDenseTableBytes)
+    {
+        if (CombTable<uint16_t, Class>::fits(dfa))
+        {
+            CombTable<uint16_t, Class> comb(dfa, acceleratedCount);
+            if (comb.bytes() < denseBytes)
+            {
+                return comb;
+            }
+        }
+        else
+        {
+            CombTable<uint32_t, Class> comb(dfa, acceleratedCount);
+            if (comb.bytes() < denseBytes)
+            {
+                return comb;
+            }
+        }
+    }
+
+    return makeDenseTable<Class>(dfa, acceleratedCount);
+}
+
+template<typename Class>
+Matcher::Table Matcher::makeDenseTable(const DFA& dfa,
+                                       std::size_t acceleratedCount)
+{
+    if (DFATable<uint8_t, Class>::fits(dfa))
+    {
+        return DFATable<uint8_t, Class>(dfa, acceleratedCount);
+    }
+
+    if (DFATable<uint16_t, Class>::fits(dfa))
+    {
+        return DFATable<uint16_t, Class>(dfa, acceleratedCount);
+    }
+
+    if (DFATable<uint32_t, Class>::fits(dfa))
+    {
+        return DFATable<uint32_t, Class>(dfa, acceleratedCount);
+    }
+
+    throw std::runtime_error("The automaton of the pattern is too large");
+}
+
+DFA Matcher::mergeAlphabet(DFA dfa)
+{
+    const auto newInputs = dfa.mergeInputs();
+
+    // Neighbouring intervals sharing an input are joined
+    Alphabet alphabet;
+    for (auto i = 0U; i < mAlphabet.size(); ++i)
+    {
+        if (!mInputs.empty() && mInputs.back() == newInputs[i])
+        {
+            alphabet.back().second = mAlphabet[i].second;
+            continue;
+        }
+
+        alphabet.push_back(mAlphabet[i]);
+        mInputs.push_back(newInputs[i]);
+    }
+
+    mAlphabet = std::move(alphabet);
+    return dfa;
+}
+
+Matcher::AnyByteClasses
+Matcher::makeByteClasses(const DFA& dfa,
+                         const Alphabet& alphabet,
+                         const std::vector<automata::InputType>& inputs)
+{
+    // Classes of the width of those of the table
+    AnyByteClasses byteClasses = ByteClasses<uint8_t>{};
+    if (!fitsClass<uint8_t>(dfa))
+    {
+        byteClasses = ByteClasses<uint16_t>{};
+    }
+
+    std::visit(
+      [&alphabet, &inputs](auto& classes)
+      {
+          using Class = typename std::decay_t<decltype(classes)>::value_type;
+
+          // The alphabet is sorted and covers every code point from 0 on
+          for (auto i = 0U; i < alphabet.size(); ++i)
+          {
+              const auto last =
+                std::min<CodePoint>(alphabet[i].second, kByteMax);
+              for (auto cp = alphabet[i].first; cp <= last; ++cp)
+              {
+                  classes.at(cp) = static_cast<Class>(inputs[i]);
+              }
+          }
+      },
+      byteClasses);
+
+    return byteClasses;
+}
+
+template<typename Class>
+Class Matcher::findInAlphabet(const ByteClasses<Class>& byteClasses,
+                              CodePoint input) const
+{
+    if (input < kByteClassCount)
+    {
+        return byteClasses[input];
+    }
+
+    return static_cast<Class>(mInputs[findInterval(mAlphabet, input)]);
+}
+
+automata::InputType Matcher::findByteClass(CodePoint byte) const
+{
+    return std::visit([byte](const auto& byteClasses)
+                      { return automata::InputType{ byteClasses[byte] }; },
+                      mByteClasses);
+}
+
+std::vector<ByteSet> Matcher::accelerate()
+{
+    std::vector<std::size_t> ranks(mDFA.stateCount(), 0);
+    std::vector<ByteSet> escapes(mDFA.sinkCount());
+
+    for (auto state = mDFA.sinkCount(); state < mDFA.stateCount(); ++state)
+    {
+        if (const auto bytes = findEscapes(state))
+        {
+            ranks[state] = 1;
+            escapes.push_back(*bytes);
+        }
+        else if (mFindStart && state == mDFA.getStartState())
+        {
+            ranks[state] = 1;
+            escapes.emplace_back();
+        }
+    }
+
+    // Stable, the accelerated states keep their order
+    mDFA.reorder(ranks);
+    return escapes;
+}
+
+std::optional<ByteSet> Matcher::findEscapes(automata::StateId state) const
+{
+    CodePoint last = kByteMax;
+
+    if (mMode == Mode::eUtf8)
+    {
+        constexpr CodePoint kAsciiMax = 0x7F;
+        for (auto i = 0U; i < mAlphabet.size(); ++i)
+        {
+            if (mAlphabet[i].second > kAsciiMax &&
+                mDFA.step(state, mInputs[i]) != state)
+            {
+                return std::nullopt;
+            }
+        }
+        last = kAsciiMax;
+    }
+
+    ByteSet escapes;
+    for (CodePoint byte = 0; byte <= last; ++byte)
+    {
+        if (mDFA.step(state, findByteClass(byte)) == state)
+        {
+            continue;
+        }
+
+        if (escapes.Count == ByteSet::kCapacity)
+        {
+            return std::nullopt;
+        }
+        escapes.Bytes[escapes.Count++] = static_cast<unsigned char>(byte);
+    }
+
+    if (escapes.Count == 0)
+    {
+        return std::nullopt;
+    }
+
+    return escapes;
+}
+
+std::size_t Matcher::findExit(std::size_t index,
+                              std::string_view bytes,
+                              std::size_t from,
+                              std::size_t& skipFrom) const
+{
+    // only the skipped start state has no bytes
+    const auto& escapes = mEscapes[index];
+    if (escapes.Count != 0)
+    {
+        return findAnyByte(bytes, from, escapes);
+    }
+
+    const auto start = mFindStart(bytes, from);
+    if (start.Offset >= bytes.size())
+    {
+        return bytes.size();
+    }
+
+    skipFrom = start.Through + 1;
+    return start.Offset;
+}
+
+template<typename Automaton>
+bool Matcher::matchBytes(const Automaton& table, const std::string& target)
+{
+    using Class = typename Automaton::InputClass;
+    const auto& byteClasses = std::get<ByteClasses<Class>>(mByteClasses);
+
+    auto state = table.start();
+    const std::string_view bytes(target);
+
+    std::size_t skipFrom = 0;
+    std::size_t pos = 0;
+    if (table.isSpecial(state) && !table.isSink(state))
+    {
+        pos = findExit(table.index(state), bytes, pos, skipFrom);
+    }
+
+    for (; pos < bytes.size(); ++pos)
+    {
+        // every byte is an index into the class table
+        const auto input = byteClasses[static_cast<unsigned char>(bytes[pos])];
+
+        // advance the DFA
+        state = table.step(state, input);
+
+        if (table.isSpecial(state))
+        {
+            // exit once the verdict can no longer change
+            if (table.isSink(state))
+            {
+                break;
+            }
+
+            // skip to the next byte leaving the accelerated state
+            if (pos + 1 >= skipFrom)
+            {
+                const auto to =
+                  findExit(table.index(state), bytes, pos + 1, skipFrom);
+                pos = to - 1;
+            }
+        }
+    }
+
+    return table.isFinal(state);
+}
+
+template<typename Automaton>
+bool Matcher::matchUtf8(const Automaton& table, const std::string& target)
+{
+    using Class = typename Automaton::InputClass;
+    const auto& byteClasses = std::get<ByteClasses<Class>>(mByteClasses);
+
+    auto state = table.start();
+    const std::string_view bytes(target);
+
+    std::size_t skipFrom = 0;
+    auto it = Utf8Iterator(target.cbegin());
+    if (table.isSpecial(state) && !table.isSink(state))
+    {
+        const auto to = findExit(table.index(state), bytes, 0, skipFrom);
+        it = Utf8Iterator(target.cbegin() + static_cast<std::ptrdiff_t>(to));
+    }
+
+    const auto end = Utf8Iterator(target.cend());
+    while (it != end)
+    {
+        const CodePoint codePoint = *it;
+        ++it;
+
+        // code points beyond the alphabet never match
+        if (codePoint > mAlphabet.back().second)
+        {
+            return false;
+        }
+
+        // lookup the codepoint in the alphabet and advance the DFA
+        state = table.step(state, findInAlphabet(byteClasses, codePoint));
+
+        if (table.isSpecial(state))
+        {
+            // exit once the verdict can no longer change
+            if (table.isSink(state))
+            {
+                break;
+            }
+
+            // skip to the next byte leaving the accelerated state. The bytes
+            // are ASCII and starts are on a character, so the skip lands on
+            // one.
+            const auto from =
+              static_cast<std::size_t>(it.base() - target.cbegin());
+            if (from >= skipFrom)
+            {
+                const auto to =
+                  findExit(table.index(state), bytes, from, skipFrom);
+                it = Utf8Iterator(target.cbegin() +
+                                  static_cast<std::ptrdiff_t>(to));
+            }
+        }
+    }
+
+    return table.isFinal(state);
+}
+
+template<typename Automaton, typename Iterator>
+bool Matcher::matchCodePoints(const Automaton& table,
+                              Iterator begin,
+                              Iterator end)
+{
+    using Class = typename Automaton::InputClass;
+    const auto& byteClasses = std::get<ByteClasses<Class>>(mByteClasses);
+
+    auto state = table.start();
+
+    for (auto it = begin; it != end; ++it)
+    {
+        const CodePoint codePoint = *it;
+
+        // code points beyond the alphabet (i.e. byte mode) never match
+        if (codePoint > mAlphabet.back().second)
+        {
+            return false;
+        }
+
+        // lookup the codepoint in the alphabet
+        auto input = findInAlphabet(byteClasses, codePoint);
+
+        // advance the DFA
+        state = table.step(state, input);
+
+        // exit once the verdict can no longer change
+        if (table.isSink(state))
+        {
+            break;
+        }
+    }
+
+    return table.isFinal(state);
+}
+
+template<typename Iterator>
+bool Matcher::matchCodePoints(Iterator begin, Iterator end)
+{
+    return std::visit([this, begin, end](const auto& table)
+                      { return matchCodePoints(table, begin, end); },
+                      mTable);
+}
+
+template<typename OnInput>
+void Matcher::forEachInput(const std::string& target, OnInput onInput) const
+{
+    std::visit(
+      [this, &target, &onInput](const auto& byteClasses)
+      {
+          if (mMode == Mode::eBytes)
+          {
+              for (const auto byte : target)
+              {
+                  if (!onInput(byteClasses[static_cast<unsigned char>(byte)]))
+                  {
+                      return;
+                  }
+              }
+              return;
+          }
+
+          const auto end = Utf8Iterator(target.cend());
+          for (auto it = Utf8Iterator(target.cbegin()); it != end; ++it)
+          {
+              const CodePoint codePoint = *it;
+              if (codePoint > mAlphabet.back().second ||
+                  !onInput(findInAlphabet(byteClasses, codePoint)))
+              {
+                  return;
+              }
+          }
+      },
+      mByteClasses);
+}
+
+std::vector<std::size_t>
+Matcher::profile(const std::vector<std::string>& samples)
+{
+    std::vector<std::size_t> visits(mDFA.stateCount(), 0);
+
+    // Mirror match(), which stops in a sink
+    for (const auto& sample : samples)
+    {
+        auto state = mDFA.getStartState();
+        ++visits[state];
+
+        forEachInput(sample,
+                     [this, &state, &visits](automata::InputType input)
+                     {
+                         state = mDFA.step(state, input);
+                         ++visits[state];
+                         return state >= mDFA.sinkCount();
+                     });
+    }
+
+    return visits;
+}
+
+void Matcher::optimize(const std::vector<std::string>& samples)
+{
+    mDFA.reorder(profile(samples));
+    mEscapes = accelerate();
+    mTable = makeTable(mDFA, mEscapes.size() - mDFA.sinkCount());
+}
+
+const Matcher::Table& Matcher::table() const
+{
+    return mTable;
+}
+
+bool Matcher::match(const std::string& target)
+{
+    if (mMode == Mode::eBytes)
+    {
+        return std::visit([this, &target](const auto& table)
+                          { return matchBytes(table, target); },
+                          mTable);
+    }
+
+    return std::visit([this, &target](const auto& table)
+                      { return matchUtf8(table, target); },
+                      mTable);
+}
+
+bool Matcher::match(const std::u16string& target)
+{
+    const auto begin = target.cbegin();
+    const auto end = target.cend();
+    return matchCodePoints(Utf16Iterator(begin, begin, end),
+                           Utf16Iterator(end, begin, end));
+}
+
+bool Matcher::match(const std::u32string& target)
+{
+    // utf-32 code units are code points
+    return matchCodePoints(target.cbegin(), target.cend());
+}
+
+} // namespace regex
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "AST.hpp"
+#include "Alphabet.hpp"
+#include "ByteSearch.hpp"
+#include "CodePoint.hpp"
+#include "CombTable.hpp"
+#include "DFA.hpp"
+#include "DFATable.hpp"
+
+#include <regex/Regex.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace regex
+{
+
+using automata::CombTable;
+using automata::DFA;
+using automata::DFATable;
+
+// Matches targets in whole against the minimized DFA of an AST
+class Matcher
+{
+public:
+    // The DFA is matched with the narrowest dense table holding its
+    // offsets, or with a comb when the dense table would be large and sparse.
+    // Either holds the inputs in the narrowest class type.
+    using Table = std::variant<DFATable<uint8_t, uint8_t>,
+                               DFATable<uint16_t, uint8_t>,
+                               DFATable<uint32_t, uint8_t>,
+                               CombTable<uint16_t, uint8_t>,
+                               CombTable<uint32_t, uint8_t>,
+                               DFATable<uint8_t, uint16_t>,
+                               DFATable<uint16_t, uint16_t>,
+                               DFATable<uint32_t, uint16_t>,
+                               CombTable<uint16_t, uint16_t>,
+                               CombTable<uint32_t, uint16_t>>;
+
+    // The first offset of a target at which a match may start, on a
+    // character, and the last offset from which on it is found again. Both
+    // npos if no match can start.
+    struct Start
+    {
+        std::size_t Offset;
+        std::size_t Through;
+    };
+
+    // Finds the start of a match from the given offset of a UTF-8 or byte
+    // target on
+    using StartFinder = std::function<Start(std::string_view, std::size_t)>;
+
+    // The start finder, if any, skips the start state to the next offset it
+    // returns. It is valid only for an unanchored AST, whose start state
+    // may be left anywhere without changing the verdict.
+    Matcher(const ast::AST& ast, Mode mode, StartFinder findStart = {});
+    bool match(const std::string& target);
+    bool match(const std::u16string& target);
+    bool match(const std::u32string& target);
+    std::vector<std::size_t> profile(const std::vector<std::string>& samples);
+    void optimize(const std::vector<std::string>& samples);
+
+    // The table the DFA is matched with
+    [[nodiscard]] const Table& table() const;
+
+private:
+    // Maps every code point in the range 0-255 directly to its
+    // alphabet index. This is the whole alphabet in byte mode. The classes
+    // have the type of those of the table.
+    static constexpr std::size_t kByteClassCount = kByteMax + 1;
+
+    template<typename Class>
+    using ByteClasses = std::array<Class, kByteClassCount>;
+
+    using AnyByteClasses =
+      std::variant<ByteClasses<uint8_t>, ByteClasses<uint16_t>>;
+
+    static AnyByteClasses
+    makeByteClasses(const DFA& dfa,
+                    const Alphabet& alphabet,
+                    const std::vector<automata::InputType>& inputs);
+
+    // Dense tables up to this size are kept, they fit into the L1 cache
+    static constexpr std::size_t kDenseTableBytes = 32 * 1024;
+
+    // Whether every input of the DFA fits into Class
+    template<typename Class>
+    static bool fitsClass(const DFA& dfa);
+
+    static Table makeTable(const DFA& dfa, std::size_t acceleratedCount);
+
+    template<typename Class>
+    static Table makeTable(const DFA& dfa, std::size_t acceleratedCount);
+
+    template<typename Class>
+    static Table makeDenseTable(const DFA& dfa, std::size_t acceleratedCount);
+
+    // Merges the alphabet intervals the minimized DFA does not distinguish.
+    // Returns the DFA on the merged inputs.
+    DFA mergeAlphabet(DFA dfa);
+
+    template<typename Class>
+    Class findInAlphabet(const ByteClasses<Class>& byteClasses,
+                         CodePoint input) const;
+
+    // The input of a code point in the range 0-255
+    automata::InputType findByteClass(CodePoint byte) const;
+
+    // Renumbers the states that are left on at most three bytes to follow
+    // the sinks, and the start state if the start finder skips it. Returns
+    // the bytes leaving every state up to the last accelerated one, none for
+    // the sinks and the skipped start state.
+    std::vector<ByteSet> accelerate();
+
+    // The offset from from on at which the accelerated state is left, or
+    // the size of the bytes. Sets the offset from which on the start state
+    // is skipped again, before that it is found at the same start.
+    std::size_t findExit(std::size_t index,
+                         std::string_view bytes,
+                         std::size_t from,
+                         std::size_t& skipFrom) const;
+
+    // The bytes leaving the state, if few enough for it to be accelerated.
+    // In UTF-8 they must all be ASCII, the bytes of every other character
+    // are skipped without decoding and must loop.
+    std::optional<ByteSet> findEscapes(automata::StateId state) const;
+
+    // Calls onInput with the input of every character of the target until
+    // it returns false or a code point is beyond the alphabet
+    template<typename OnInput>
+    void forEachInput(const std::string& target, OnInput onInput) const;
+
+    // Both skip ahead to the next byte leaving an accelerated state. States
+    // are stepped through between a skip of the start state and the required
+    // literal it found.
+    template<typename Automaton>
+    bool matchBytes(const Automaton& table, const std::string& target);
+
+    template<typename Automaton>
+    bool matchUtf8(const Automaton& table, const std::string& target);
+
+    // Iterator shall dereference to decoded code points
+    template<typename Automaton, typename Iterator>
+    bool matchCodePoints(const Automaton& table, Iterator begin, Iterator end);
+
+    template<typename Iterator>
+    bool matchCodePoints(Iterator begin, Iterator end);
+
+    Mode mMode;
+    StartFinder mFindStart;
+    Alphabet mAlphabet;
+
+    // The input of every interval of the alphabet. Several intervals may
+    // share one input.
+    std::vector<automata::InputType> mInputs;
+    DFA mDFA;
+    AnyByteClasses mByteClasses;
+
+    // The bytes leaving every accelerated state, indexed by state id
+    std::vector<ByteSet> mEscapes;
+    Table mTable;
+};
+
+} // namespace regex
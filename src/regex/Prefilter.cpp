@@ -0,0 +1,291 @@
+#include "Prefilter.hpp"
+
+#include "ByteSearch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace regex
+{
+
+namespace
+{
+
+// A rough rank of how often a byte occurs in text and logs, higher is more
+// frequent
+int frequency(unsigned char byte)
+{
+    if (byte == ' ' || byte == 'e' || byte == 't' || byte == 'a' ||
+        byte == 'o' || byte == 'i' || byte == 'n' || byte == 's')
+    {
+        return 5;
+    }
+
+    if (byte >= 'a' && byte <= 'z')
+    {
+        return 4;
+    }
+
+    if ((byte >= '0' && byte <= '9') || byte >= 0x80)
+    {
+        return 3;
+    }
+
+    if (byte >= 'A' && byte <= 'Z')
+    {
+        return 2;
+    }
+
+    if (byte == '\n' || byte == '.' || byte == ',' || byte == '/' ||
+        byte == '-' || byte == ':' || byte == '_')
+    {
+        return 2;
+    }
+
+    return 1;
+}
+
+// The rare byte paired with the rarest of the others. One of another value
+// than the rare byte is preferred, it rules out more candidates.
+BytePair makeBytePair(std::string_view needle, std::size_t rare)
+{
+    constexpr int kSameValue = 8;
+
+    const auto rank = [needle, rare](std::size_t index)
+    {
+        const auto byte = static_cast<unsigned char>(needle[index]);
+        return frequency(byte) +
+               (needle[index] == needle[rare] ? kSameValue : 0);
+    };
+
+    std::size_t partner = rare == 0 ? 1 : 0;
+    for (std::size_t index = 0; index < needle.size(); ++index)
+    {
+        if (index != rare && rank(index) < rank(partner))
+        {
+            partner = index;
+        }
+    }
+
+    BytePair pair;
+    pair.Bytes = { static_cast<unsigned char>(needle[rare]),
+                   static_cast<unsigned char>(needle[partner]) };
+    pair.Offsets = { rare, partner };
+    return pair;
+}
+
+bool startsWith(std::string_view target, std::string_view prefix)
+{
+    return target.substr(0, prefix.size()) == prefix;
+}
+
+bool endsWith(std::string_view target, std::string_view suffix)
+{
+    return target.size() >= suffix.size() &&
+           target.substr(target.size() - suffix.size()) == suffix;
+}
+
+} // namespace
+
+std::string encodeLiteral(const std::u32string& literal, Mode mode)
+{
+    std::string encoded;
+
+    for (const auto cp : literal)
+    {
+        if (mode == Mode::eBytes || cp < 0x80)
+        {
+            encoded += static_cast<char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+            encoded += static_cast<char>(0xC0 | (cp >> 6));
+            encoded += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            encoded += static_cast<char>(0xE0 | (cp >> 12));
+            encoded += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            encoded += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            encoded += static_cast<char>(0xF0 | (cp >> 18));
+            encoded += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            encoded += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            encoded += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    return encoded;
+}
+
+std::size_t findLiteral(std::string_view haystack,
+                        std::string_view needle,
+                        std::size_t rare)
+{
+    if (needle.empty())
+    {
+        return 0;
+    }
+
+    if (haystack.size() < needle.size())
+    {
+        return std::string_view::npos;
+    }
+
+    if (needle.size() == 1)
+    {
+        const auto* hit = static_cast<const char*>(
+          std::memchr(haystack.data(), needle[0], haystack.size()));
+        return hit == nullptr
+                 ? std::string_view::npos
+                 : static_cast<std::size_t>(hit - haystack.data());
+    }
+
+    const auto* const begin = haystack.data();
+    const auto lastStart = haystack.size() - needle.size();
+
+    // memchr for the rare byte is fastest while it occurs rarely. Once the
+    // candidates are dense, pairing it with a second byte skips most of them
+    // 16 at a time.
+    constexpr std::size_t kMinMisses = 8;
+    constexpr std::size_t kMinSkip = 64;
+    std::optional<BytePair> pair;
+    std::size_t misses = 0;
+
+    for (std::size_t start = 0; start <= lastStart; ++start)
+    {
+        if (pair)
+        {
+            start = findBytePair(haystack, start, lastStart, *pair);
+            if (start > lastStart)
+            {
+                break;
+            }
+        }
+        else
+        {
+            const auto* hit = static_cast<const char*>(std::memchr(
+              begin + start + rare, needle[rare], lastStart - start + 1));
+            if (hit == nullptr)
+            {
+                break;
+            }
+            start = static_cast<std::size_t>(hit - begin) - rare;
+        }
+
+        // the whole needle is compared at every candidate
+        if (std::memcmp(begin + start, needle.data(), needle.size()) == 0)
+        {
+            return start;
+        }
+
+        ++misses;
+        if (!pair && misses >= kMinMisses && start < misses * kMinSkip)
+        {
+            pair = makeBytePair(needle, rare);
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+std::size_t findRarestByte(std::string_view literal)
+{
+    const auto rarest = std::min_element(
+      literal.begin(),
+      literal.end(),
+      [](char lhs, char rhs)
+      {
+          return frequency(static_cast<unsigned char>(lhs)) <
+                 frequency(static_cast<unsigned char>(rhs));
+      });
+
+    return static_cast<std::size_t>(rarest - literal.begin());
+}
+
+Prefilter::Prefilter(const ast::Literals& literals, Mode mode)
+  : mMode{ mode }
+  , mPrefix{ encodeLiteral(literals.Prefix, mode) }
+  , mSuffix{ encodeLiteral(literals.Suffix, mode) }
+  , mRequired{ encodeLiteral(literals.Required, mode) }
+  , mRare{ findRarestByte(mRequired) }
+{
+    // A code point takes up to four bytes in UTF-8
+    constexpr std::size_t kMaxUtf8Length = 4;
+    if (!mRequired.empty() && literals.RequiredOffset)
+    {
+        mRequiredOffset = static_cast<std::size_t>(*literals.RequiredOffset) *
+                          (mode == Mode::eUtf8 ? kMaxUtf8Length : 1);
+    }
+
+    // The set is only searched for if it is more selective than the
+    // required literal
+    const auto isSelective =
+      std::all_of(literals.RequiredAny.begin(),
+                  literals.RequiredAny.end(),
+                  [&literals](const auto& literal)
+                  { return literal.size() > literals.Required.size(); });
+
+    if (!literals.RequiredAny.empty() && isSelective)
+    {
+        std::vector<std::string> encoded;
+        for (const auto& literal : literals.RequiredAny)
+        {
+            encoded.push_back(encodeLiteral(literal, mode));
+        }
+        mRequiredAny.emplace(std::move(encoded));
+    }
+}
+
+bool Prefilter::mayMatch(std::string_view target) const
+{
+    return startsWith(target, mPrefix) && endsWith(target, mSuffix) &&
+           maySearch(target);
+}
+
+bool Prefilter::maySearch(std::string_view target) const
+{
+    if (mRequiredAny &&
+        mRequiredAny->find(target) == std::string_view::npos)
+    {
+        return false;
+    }
+
+    return findLiteral(target, mRequired, mRare) != std::string_view::npos;
+}
+
+bool Prefilter::isStartBounded() const
+{
+    return mRequiredOffset.has_value();
+}
+
+std::size_t Prefilter::findRequired(std::string_view target,
+                                    std::size_t from) const
+{
+    const auto found = findLiteral(target.substr(from), mRequired, mRare);
+    return found == std::string_view::npos ? found : from + found;
+}
+
+std::size_t Prefilter::findStart(std::string_view target,
+                                 std::size_t from,
+                                 std::size_t required) const
+{
+    auto start = required - std::min(required - from, *mRequiredOffset);
+
+    // Back up to the lead byte of a character
+    constexpr unsigned char kContinuationMask = 0xC0;
+    constexpr unsigned char kContinuationByte = 0x80;
+    while (mMode == Mode::eUtf8 && start > from &&
+           (static_cast<unsigned char>(target[start]) & kContinuationMask) ==
+             kContinuationByte)
+    {
+        --start;
+    }
+
+    return start;
+}
+
+} // namespace regex
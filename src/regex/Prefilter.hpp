@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Literals.hpp"
+#include "Teddy.hpp"
+
+#include <regex/Regex.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace regex
+{
+
+// Encodes the literal like the targets of the mode, UTF-8 or one byte per
+// code point
+[[nodiscard]] std::string encodeLiteral(const std::u32string& literal,
+                                        Mode mode);
+
+// Finds the first occurrence of needle in haystack or returns npos. Scans
+// for the byte of the needle at rare with memchr, and for it together with
+// a second rare byte once it occurs often. Compares the whole needle at
+// every candidate. The byte should be the one of the needle least likely to
+// occur in the haystack.
+[[nodiscard]] std::size_t findLiteral(std::string_view haystack,
+                                      std::string_view needle,
+                                      std::size_t rare);
+
+// The index of the byte of the literal that is least likely to occur in
+// text, judged by a fixed ranking of byte frequencies
+[[nodiscard]] std::size_t findRarestByte(std::string_view literal);
+
+// Rejects targets cheaply that lack the literals every match has, before
+// they are run through the automaton
+class Prefilter
+{
+public:
+    Prefilter(const ast::Literals& literals, Mode mode);
+
+    // False if the target as a whole cannot match
+    [[nodiscard]] bool mayMatch(std::string_view target) const;
+
+    // False if no part of the target can match
+    [[nodiscard]] bool maySearch(std::string_view target) const;
+
+    // Whether the required literal is found at a bounded distance from the
+    // start of every match
+    [[nodiscard]] bool isStartBounded() const;
+
+    // The first occurrence of the required literal from from on, or npos
+    [[nodiscard]] std::size_t findRequired(std::string_view target,
+                                           std::size_t from) const;
+
+    // The first offset from from on at which a match may start, given the
+    // first occurrence of the required literal from there on. Always at the
+    // start of a character. The start shall be bounded.
+    [[nodiscard]] std::size_t findStart(std::string_view target,
+                                        std::size_t from,
+                                        std::size_t required) const;
+
+private:
+    Mode mMode;
+
+    // Encoded like the targets
+    std::string mPrefix;
+    std::string mSuffix;
+    std::string mRequired;
+    std::size_t mRare;
+
+    // The most bytes of a match before the required literal, if bounded
+    std::optional<std::size_t> mRequiredOffset;
+
+    // One of these literals is in every match, if it is more selective than
+    // the required literal
+    std::optional<Teddy> mRequiredAny;
+};
+
+} // namespace regex
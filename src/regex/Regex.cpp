@@ -1,88 +1,203 @@
 #include <regex/Regex.hpp>
 
 #include "AST.hpp"
-#include "Alphabet.hpp"
-#include "CodePoint.hpp"
-#include "DFA.hpp"
+#include "ClassRun.hpp"
+#include "LiteralMatcher.hpp"
+#include "Literals.hpp"
+#include "Matcher.hpp"
 #include "Parser.hpp"
-#include "Utf8Iterator.hpp"
+#include "Prefilter.hpp"
+#include "Simplifier.hpp"
 
-#include <algorithm>
-#include <cassert>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace regex
 {
 
-using automata::DFA;
 using parser::Parser;
 
+namespace
+{
+
+// Wraps the AST into .*(ast).* over every code point. Its automaton accepts
+// the targets with a matching part and, once minimized, enters an accepting
+// sink right after the first match.
+ast::AST makeUnanchored(ast::AST ast)
+{
+    const auto any = ast.addCharacterClass({ { 0, ast.codePointMax() } });
+    const auto anything = ast.addQuantifier(any, 0, 0, false);
+    ast.setRoot(ast.addConcatenation({ anything, ast.root(), anything }));
+    return ast;
+}
+
+} // namespace
+
 class Regex::RegexImpl
 {
 public:
-    explicit RegexImpl(const std::string& pattern);
+    RegexImpl(const std::string& pattern, Mode mode);
     bool match(const std::string& target);
+    bool match(const std::u16string& target);
+    bool match(const std::u32string& target);
+    bool search(const std::string& target);
+    bool search(const std::u16string& target);
+    bool search(const std::u32string& target);
+    std::vector<std::size_t> profile(const std::vector<std::string>& samples);
+    void optimize(const std::vector<std::string>& samples);
 
 private:
-    RegexImpl(const ast::AST& ast);
+    RegexImpl(ast::AST ast, Mode mode);
+
+    // Takes the AST by reference, it is only moved from once the literals
+    // have been extracted from it
+    RegexImpl(ast::AST&& ast, const ast::Literals& literals, Mode mode);
+
+    // The matcher is only built on first use for literals, which are
+    // matched without it
+    Matcher& matcher();
 
-    automata::InputType findInAlphabet(CodePoint input);
+    // The searcher is built on the first search
+    Matcher& searcher();
 
-    Alphabet mAlphabet;
-    DFA mDFA;
+    Mode mMode;
+    ast::AST mAST;
+    Prefilter mPrefilter;
+    std::optional<LiteralMatcher> mLiteral;
+
+    // Set when the pattern is one class repeated. ASCII targets are matched
+    // without the matcher.
+    std::optional<ClassRun> mClassRun;
+    std::optional<Matcher> mMatcher;
+    std::optional<Matcher> mSearcher;
 };
 
-Regex::RegexImpl::RegexImpl(const std::string& pattern)
-  : RegexImpl{ Parser(pattern).parse() }
+Regex::RegexImpl::RegexImpl(const std::string& pattern, Mode mode)
+  : RegexImpl{ ast::simplify(Parser(pattern, mode).parse()), mode }
 {
 }
 
-Regex::RegexImpl::RegexImpl(const ast::AST& ast)
-  : mAlphabet{ ast.makeAlphabet() }
-  , mDFA{ ast.makeNFA(mAlphabet).makeDFA() }
+Regex::RegexImpl::RegexImpl(ast::AST ast, Mode mode)
+  : RegexImpl{ std::move(ast), ast::extractLiterals(ast), mode }
 {
 }
 
-automata::InputType Regex::RegexImpl::findInAlphabet(CodePoint input)
+Regex::RegexImpl::RegexImpl(ast::AST&& ast,
+                            const ast::Literals& literals,
+                            Mode mode)
+  : mMode{ mode }
+  , mAST{ std::move(ast) }
+  , mPrefilter{ literals, mode }
 {
-    const auto within = [input](CodePointInterval interval)
-    { return input >= interval.first && input <= interval.second; };
+    if (literals.IsExact)
+    {
+        mLiteral.emplace(literals.Prefix, mode);
+    }
+    else
+    {
+        mClassRun = findClassRun(mAST);
+        mMatcher.emplace(mAST, mode);
+    }
+}
 
-    const auto begin = mAlphabet.begin();
-    const auto end = mAlphabet.end();
-    auto result = std::find_if(begin, end, within);
-    assert(result != end);
+Matcher& Regex::RegexImpl::matcher()
+{
+    if (!mMatcher)
+    {
+        mMatcher.emplace(mAST, mMode);
+    }
+    return *mMatcher;
+}
 
-    // The index is the input to the automata
-    return static_cast<automata::InputType>(std::distance(begin, result));
+Matcher& Regex::RegexImpl::searcher()
+{
+    if (!mSearcher)
+    {
+        // skip the start state to the candidates of the required literal
+        Matcher::StartFinder findStart;
+        if (mPrefilter.isStartBounded())
+        {
+            findStart = [this](std::string_view target, std::size_t from)
+            {
+                const auto required = mPrefilter.findRequired(target, from);
+                if (required == std::string_view::npos)
+                {
+                    return Matcher::Start{ required, required };
+                }
+                return Matcher::Start{
+                    mPrefilter.findStart(target, from, required), required
+                };
+            };
+        }
+        mSearcher.emplace(makeUnanchored(mAST), mMode, std::move(findStart));
+    }
+    return *mSearcher;
 }
 
 bool Regex::RegexImpl::match(const std::string& target)
 {
-    auto state = mDFA.getStartState();
-
-    // NOLINTNEXTLINE(modernize-loop-convert)
-    for (Utf8Iterator it = target.cbegin(); it != target.cend(); ++it)
+    if (mLiteral)
     {
-        // lookup the codepoint in the alphabet
-        auto input = findInAlphabet(*it);
-
-        // advance the DFA
-        state = mDFA.step(state, input);
+        return mLiteral->match(target);
+    }
 
-        // exit on a dead state
-        if (mDFA.isDeadState(state))
+    if (mClassRun)
+    {
+        const auto verdict = mClassRun->match(target);
+        if (verdict != ClassRun::Verdict::eUnknown)
         {
-            break;
+            return verdict == ClassRun::Verdict::eMatch;
         }
     }
 
-    return mDFA.isFinalState(state);
+    return mPrefilter.mayMatch(target) && mMatcher->match(target);
+}
+
+bool Regex::RegexImpl::match(const std::u16string& target)
+{
+    return mLiteral ? mLiteral->match(target) : mMatcher->match(target);
+}
+
+bool Regex::RegexImpl::match(const std::u32string& target)
+{
+    return mLiteral ? mLiteral->match(target) : mMatcher->match(target);
+}
+
+bool Regex::RegexImpl::search(const std::string& target)
+{
+    if (mLiteral)
+    {
+        return mLiteral->search(target);
+    }
+
+    return mPrefilter.maySearch(target) && searcher().match(target);
+}
+
+bool Regex::RegexImpl::search(const std::u16string& target)
+{
+    return mLiteral ? mLiteral->search(target) : searcher().match(target);
+}
+
+bool Regex::RegexImpl::search(const std::u32string& target)
+{
+    return mLiteral ? mLiteral->search(target) : searcher().match(target);
 }
 
-Regex::Regex(const std::string& pattern)
-  : impl{ std::make_unique<RegexImpl>(pattern) }
+std::vector<std::size_t>
+Regex::RegexImpl::profile(const std::vector<std::string>& samples)
+{
+    return matcher().profile(samples);
+}
+
+void Regex::RegexImpl::optimize(const std::vector<std::string>& samples)
+{
+    matcher().optimize(samples);
+}
+
+Regex::Regex(const std::string& pattern, Mode mode)
+  : impl{ std::make_unique<RegexImpl>(pattern, mode) }
 {
 }
 
@@ -93,4 +208,39 @@ bool Regex::match(const std::string& target)
     return impl->match(target);
 }
 
-} // namespace regex
\ No newline at end of file
+bool Regex::match(const std::u16string& target)
+{
+    return impl->match(target);
+}
+
+bool Regex::match(const std::u32string& target)
+{
+    return impl->match(target);
+}
+
+bool Regex::search(const std::string& target)
+{
+    return impl->search(target);
+}
+
+bool Regex::search(const std::u16string& target)
+{
+    return impl->search(target);
+}
+
+bool Regex::search(const std::u32string& target)
+{
+    return impl->search(target);
+}
+
+std::vector<std::size_t> Regex::profile(const std::vector<std::string>& samples)
+{
+    return impl->profile(samples);
+}
+
+void Regex::optimize(const std::vector<std::string>& samples)
+{
+    impl->optimize(samples);
+}
+
+} // namespace regex
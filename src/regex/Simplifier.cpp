@@ -0,0 +1,571 @@
+#include "Simplifier.hpp"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace regex::ast
+{
+
+namespace
+{
+
+// Rebuilds an AST bottom up. Nodes are hash-consed, so structurally equal
+// subexpressions get the same id and can be compared by id.
+class Simplifier
+{
+public:
+    explicit Simplifier(const AST& ast)
+      : mInput{ ast }
+      , mOutput{ ast.codePointMax() }
+    {
+    }
+
+    AST run();
+
+private:
+    // A node as a repetition of an inner expression, x is x{1,1}
+    struct Repetition
+    {
+        NodeId Inner;
+        uint64_t Min;
+        uint64_t Max;
+        bool IsMaxBounded;
+    };
+
+    template<typename Make>
+    NodeId intern(std::vector<uint64_t> key, Make&& make);
+
+    NodeId makeEpsilon();
+    NodeId makeNull();
+    NodeId makeCharacterClass(std::vector<CodePointInterval> intervals);
+    NodeId makeQuantifier(NodeId inner,
+                          uint64_t min,
+                          uint64_t max,
+                          bool isMaxBounded);
+    NodeId makeConcatenation(const std::vector<NodeId>& items);
+    NodeId makeAlternative(const std::vector<NodeId>& alternatives);
+
+    void appendItem(std::vector<NodeId>& items, NodeId item);
+    [[nodiscard]] Repetition asRepetition(NodeId id) const;
+    [[nodiscard]] std::vector<NodeId> itemsOf(NodeId id) const;
+
+    std::vector<NodeId> factorPrefixes(const std::vector<NodeId>& alternatives);
+    std::vector<NodeId> factorSuffixes(const std::vector<NodeId>& alternatives);
+
+    const AST& mInput;
+    AST mOutput;
+    std::map<std::vector<uint64_t>, NodeId> mInterned;
+};
+
+AST Simplifier::run()
+{
+    struct Frame
+    {
+        NodeId Id;
+        bool IsEntered;
+    };
+
+    // The simplified children of the nodes left so far, in order
+    std::vector<NodeId> results;
+    std::vector<Frame> stack = { { mInput.root(), false } };
+
+    const auto pop = [&results](std::size_t count)
+    {
+        const auto first = results.end() - static_cast<std::ptrdiff_t>(count);
+        auto popped = std::vector<NodeId>(first, results.end());
+        results.erase(first, results.end());
+        return popped;
+    };
+
+    while (!stack.empty())
+    {
+        const auto [id, isEntered] = stack.back();
+        const auto& node = mInput[id];
+
+        if (!isEntered)
+        {
+            stack.back().IsEntered = true;
+
+            if (node.Kind == NodeKind::eQuantifier)
+            {
+                stack.push_back({ node.Inner, false });
+            }
+            else if (node.Kind == NodeKind::eAlternative ||
+                     node.Kind == NodeKind::eConcatenation)
+            {
+                const auto children = mInput.children(node);
+                for (auto i = children.size(); i > 0; --i)
+                {
+                    stack.push_back({ children[i - 1], false });
+                }
+            }
+            continue;
+        }
+
+        stack.pop_back();
+
+        switch (node.Kind)
+        {
+            case NodeKind::eAlternative:
+            {
+                results.push_back(makeAlternative(pop(node.Count)));
+                break;
+            }
+            case NodeKind::eConcatenation:
+            {
+                results.push_back(makeConcatenation(pop(node.Count)));
+                break;
+            }
+            case NodeKind::eQuantifier:
+            {
+                const auto inner = pop(1).front();
+                results.push_back(makeQuantifier(
+                  inner, node.Min, node.Max, node.IsMaxBounded));
+                break;
+            }
+            case NodeKind::eEpsilon:
+            {
+                results.push_back(makeEpsilon());
+                break;
+            }
+            case NodeKind::eNull:
+            {
+                results.push_back(makeNull());
+                break;
+            }
+            case NodeKind::eCharacterClass:
+            {
+                const auto intervals = mInput.intervals(node);
+                results.push_back(makeCharacterClass(
+                  { intervals.begin(), intervals.end() }));
+                break;
+            }
+        }
+    }
+
+    mOutput.setRoot(results.back());
+    return std::move(mOutput);
+}
+
+template<typename Make>
+NodeId Simplifier::intern(std::vector<uint64_t> key, Make&& make)
+{
+    const auto it = mInterned.find(key);
+    if (it != mInterned.end())
+    {
+        return it->second;
+    }
+
+    const auto id = make();
+    mInterned.emplace(std::move(key), id);
+    return id;
+}
+
+NodeId Simplifier::makeEpsilon()
+{
+    return intern({ static_cast<uint64_t>(NodeKind::eEpsilon) },
+                  [this]() { return mOutput.addEpsilon(); });
+}
+
+NodeId Simplifier::makeNull()
+{
+    return intern({ static_cast<uint64_t>(NodeKind::eNull) },
+                  [this]() { return mOutput.addNull(); });
+}
+
+NodeId Simplifier::makeCharacterClass(std::vector<CodePointInterval> intervals)
+{
+    if (intervals.empty())
+    {
+        return makeNull();
+    }
+
+    merge(intervals);
+
+    std::vector<uint64_t> key = { static_cast<uint64_t>(
+      NodeKind::eCharacterClass) };
+    for (const auto& [start, end] : intervals)
+    {
+        key.push_back(start);
+        key.push_back(end);
+    }
+
+    return intern(std::move(key),
+                  [this, &intervals]()
+                  { return mOutput.addCharacterClass(intervals); });
+}
+
+NodeId Simplifier::makeQuantifier(NodeId inner,
+                                  uint64_t min,
+                                  uint64_t max,
+                                  bool isMaxBounded)
+{
+    // x{0,0}
+    if (isMaxBounded && max == 0)
+    {
+        return makeEpsilon();
+    }
+
+    const auto& node = mOutput[inner];
+
+    if (node.Kind == NodeKind::eEpsilon)
+    {
+        return makeEpsilon();
+    }
+
+    if (node.Kind == NodeKind::eNull)
+    {
+        return min == 0 ? makeEpsilon() : makeNull();
+    }
+
+    // x{1,1}
+    if (isMaxBounded && min == 1 && max == 1)
+    {
+        return inner;
+    }
+
+    // Repeating x*, x+ or x? any number of times, or making x* or x+
+    // optional, is x* or x+
+    if (node.Kind == NodeKind::eQuantifier && min <= 1 && node.Min <= 1)
+    {
+        const auto isOuterStar = !isMaxBounded;
+        const auto isOuterOptional = isMaxBounded && min == 0 && max == 1;
+        const auto isInnerStar = !node.IsMaxBounded;
+        const auto isInnerOptional = node.IsMaxBounded && node.Max == 1;
+
+        if ((isOuterStar && (isInnerStar || isInnerOptional)) ||
+            (isOuterOptional && isInnerStar))
+        {
+            return makeQuantifier(node.Inner, min * node.Min, 0, false);
+        }
+    }
+
+    return intern({ static_cast<uint64_t>(NodeKind::eQuantifier),
+                    inner,
+                    min,
+                    isMaxBounded ? max : 0,
+                    isMaxBounded ? 1U : 0U },
+                  [this, inner, min, max, isMaxBounded]()
+                  {
+                      return mOutput.addQuantifier(
+                        inner, min, isMaxBounded ? max : 0, isMaxBounded);
+                  });
+}
+
+Simplifier::Repetition Simplifier::asRepetition(NodeId id) const
+{
+    const auto& node = mOutput[id];
+    if (node.Kind == NodeKind::eQuantifier)
+    {
+        return { node.Inner, node.Min, node.Max, node.IsMaxBounded };
+    }
+    return { id, 1, 1, true };
+}
+
+void Simplifier::appendItem(std::vector<NodeId>& items, NodeId item)
+{
+    // x{a,} next to x{b,c} is x{a+b,}. Merging only pays off when one side
+    // is unbounded, otherwise the automaton keeps its size and common
+    // prefixes of alternatives are harder to spot.
+    if (!items.empty())
+    {
+        const auto lhs = asRepetition(items.back());
+        const auto rhs = asRepetition(item);
+
+        if (lhs.Inner == rhs.Inner && (!lhs.IsMaxBounded || !rhs.IsMaxBounded))
+        {
+            items.back() =
+              makeQuantifier(lhs.Inner, lhs.Min + rhs.Min, 0, false);
+            return;
+        }
+    }
+
+    items.push_back(item);
+}
+
+NodeId Simplifier::makeConcatenation(const std::vector<NodeId>& items)
+{
+    std::vector<NodeId> flat;
+
+    for (const auto item : items)
+    {
+        const auto& node = mOutput[item];
+        switch (node.Kind)
+        {
+            case NodeKind::eNull:
+            {
+                return makeNull();
+            }
+            case NodeKind::eEpsilon:
+            {
+                break;
+            }
+            case NodeKind::eConcatenation:
+            {
+                // Appending may add nodes, so the children are copied first
+                for (const auto child : itemsOf(item))
+                {
+                    appendItem(flat, child);
+                }
+                break;
+            }
+            default:
+            {
+                appendItem(flat, item);
+                break;
+            }
+        }
+    }
+
+    if (flat.empty())
+    {
+        return makeEpsilon();
+    }
+
+    if (flat.size() == 1)
+    {
+        return flat.front();
+    }
+
+    std::vector<uint64_t> key = { static_cast<uint64_t>(
+      NodeKind::eConcatenation) };
+    key.insert(key.end(), flat.begin(), flat.end());
+
+    return intern(std::move(key),
+                  [this, &flat]() { return mOutput.addConcatenation(flat); });
+}
+
+NodeId Simplifier::makeAlternative(const std::vector<NodeId>& alternatives)
+{
+    std::vector<NodeId> flat;
+    std::vector<CodePointInterval> intervals;
+
+    // Nested alternatives are already flat, so one level of inlining is
+    // enough
+    const auto add = [this, &flat, &intervals](NodeId id)
+    {
+        const auto& node = mOutput[id];
+        if (node.Kind == NodeKind::eCharacterClass)
+        {
+            const auto classIntervals = mOutput.intervals(node);
+            intervals.insert(
+              intervals.end(), classIntervals.begin(), classIntervals.end());
+        }
+        else if (node.Kind != NodeKind::eNull)
+        {
+            flat.push_back(id);
+        }
+    };
+
+    for (const auto alternative : alternatives)
+    {
+        const auto& node = mOutput[alternative];
+        if (node.Kind == NodeKind::eAlternative)
+        {
+            for (const auto child : mOutput.children(node))
+            {
+                add(child);
+            }
+        }
+        else
+        {
+            add(alternative);
+        }
+    }
+
+    // The classes of an alternative match like a single class
+    if (!intervals.empty())
+    {
+        flat.push_back(makeCharacterClass(std::move(intervals)));
+    }
+
+    flat = factorSuffixes(factorPrefixes(flat));
+
+    // The order of the alternatives does not matter to the language
+    std::sort(flat.begin(), flat.end());
+    flat.erase(std::unique(flat.begin(), flat.end()), flat.end());
+
+    if (flat.empty())
+    {
+        return makeNull();
+    }
+
+    if (flat.size() == 1)
+    {
+        return flat.front();
+    }
+
+    std::vector<uint64_t> key = { static_cast<uint64_t>(
+      NodeKind::eAlternative) };
+    key.insert(key.end(), flat.begin(), flat.end());
+
+    return intern(std::move(key),
+                  [this, &flat]() { return mOutput.addAlternative(flat); });
+}
+
+std::vector<NodeId> Simplifier::itemsOf(NodeId id) const
+{
+    const auto& node = mOutput[id];
+    switch (node.Kind)
+    {
+        case NodeKind::eEpsilon:
+        {
+            return {};
+        }
+        case NodeKind::eConcatenation:
+        {
+            const auto children = mOutput.children(node);
+            return { children.begin(), children.end() };
+        }
+        default:
+        {
+            return { id };
+        }
+    }
+}
+
+std::vector<NodeId>
+Simplifier::factorPrefixes(const std::vector<NodeId>& alternatives)
+{
+    // Alternatives are grouped by their first item. Every group of two or
+    // more turns into its longest common prefix followed by the alternative
+    // of the remainders, which is factored in turn. This builds a trie.
+    std::vector<std::vector<NodeId>> sequences;
+    std::vector<std::vector<std::size_t>> groups;
+    std::unordered_map<NodeId, std::size_t> groupOf;
+    std::vector<NodeId> factored;
+
+    for (auto i = 0U; i < alternatives.size(); ++i)
+    {
+        sequences.push_back(itemsOf(alternatives[i]));
+        if (sequences.back().empty())
+        {
+            factored.push_back(alternatives[i]);
+            continue;
+        }
+
+        const auto [it, isInserted] =
+          groupOf.emplace(sequences.back().front(), groups.size());
+        if (isInserted)
+        {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+
+    for (const auto& group : groups)
+    {
+        if (group.size() == 1)
+        {
+            factored.push_back(alternatives[group.front()]);
+            continue;
+        }
+
+        const auto& first = sequences[group.front()];
+        auto length = first.size();
+        for (const auto member : group)
+        {
+            const auto& sequence = sequences[member];
+            const auto mismatch = std::mismatch(
+              first.begin(),
+              first.begin() + static_cast<std::ptrdiff_t>(
+                                std::min(length, sequence.size())),
+              sequence.begin());
+            length = static_cast<std::size_t>(mismatch.first - first.begin());
+        }
+
+        std::vector<NodeId> remainders;
+        for (const auto member : group)
+        {
+            const auto& sequence = sequences[member];
+            remainders.push_back(makeConcatenation(
+              { sequence.begin() + static_cast<std::ptrdiff_t>(length),
+                sequence.end() }));
+        }
+
+        auto items = std::vector<NodeId>(
+          first.begin(), first.begin() + static_cast<std::ptrdiff_t>(length));
+        items.push_back(makeAlternative(remainders));
+        factored.push_back(makeConcatenation(items));
+    }
+
+    return factored;
+}
+
+std::vector<NodeId>
+Simplifier::factorSuffixes(const std::vector<NodeId>& alternatives)
+{
+    // The mirror image of factorPrefixes, grouping by the last item
+    std::vector<std::vector<NodeId>> sequences;
+    std::vector<std::vector<std::size_t>> groups;
+    std::unordered_map<NodeId, std::size_t> groupOf;
+    std::vector<NodeId> factored;
+
+    for (auto i = 0U; i < alternatives.size(); ++i)
+    {
+        sequences.push_back(itemsOf(alternatives[i]));
+        if (sequences.back().empty())
+        {
+            factored.push_back(alternatives[i]);
+            continue;
+        }
+
+        const auto [it, isInserted] =
+          groupOf.emplace(sequences.back().back(), groups.size());
+        if (isInserted)
+        {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+
+    for (const auto& group : groups)
+    {
+        if (group.size() == 1)
+        {
+            factored.push_back(alternatives[group.front()]);
+            continue;
+        }
+
+        const auto& first = sequences[group.front()];
+        auto length = first.size();
+        for (const auto member : group)
+        {
+            const auto& sequence = sequences[member];
+            const auto mismatch = std::mismatch(
+              first.rbegin(),
+              first.rbegin() + static_cast<std::ptrdiff_t>(
+                                 std::min(length, sequence.size())),
+              sequence.rbegin());
+            length = static_cast<std::size_t>(mismatch.first - first.rbegin());
+        }
+
+        std::vector<NodeId> remainders;
+        for (const auto member : group)
+        {
+            const auto& sequence = sequences[member];
+            remainders.push_back(makeConcatenation(
+              { sequence.begin(),
+                sequence.end() - static_cast<std::ptrdiff_t>(length) }));
+        }
+
+        auto items = std::vector<NodeId>{ makeAlternative(remainders) };
+        items.insert(items.end(),
+                     first.end() - static_cast<std::ptrdiff_t>(length),
+                     first.end());
+        factored.push_back(makeConcatenation(items));
+    }
+
+    return factored;
+}
+
+} // namespace
+
+AST simplify(const AST& ast)
+{
+    return Simplifier(ast).run();
+}
+
+} // namespace regex::ast
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "AST.hpp"
+
+namespace regex::ast
+{
+
+// Rewrites the AST into an equivalent one that lowers into a smaller
+// automaton. Nested alternatives and concatenations are flattened, classes
+// of an alternative are merged, common prefixes and suffixes of alternatives
+// are factored out, repetitions of the same expression next to each other
+// are merged and trivial quantifiers are folded. Structurally equal
+// subexpressions are shared, so the result may be a DAG rather than a tree.
+[[nodiscard]] AST simplify(const AST& ast);
+
+} // namespace regex::ast
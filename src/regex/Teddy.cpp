@@ -0,0 +1,194 @@
+#include "Teddy.hpp"
+
+#include "ByteSearch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(REGEX_SSSE3_KERNELS)
+#include <tmmintrin.h>
+#endif
+
+namespace regex
+{
+
+namespace
+{
+
+constexpr std::size_t kBlock = 16;
+
+#if defined(REGEX_SSSE3_KERNELS)
+
+// Returns the start of the first block of 16 positions from from on with a
+// candidate and stores the buckets of each of its positions. A block is only
+// scanned when all of its fingerprinted bytes are in the haystack, so a
+// start closer to the end is the first position not scanned.
+__attribute__((target("ssse3"))) std::size_t
+findCandidateBlock(std::string_view haystack,
+                   std::size_t from,
+                   std::size_t maskLength,
+                   const uint8_t* low,
+                   const uint8_t* high,
+                   uint8_t* buckets)
+{
+    const auto nibbleMask = _mm_set1_epi8(0x0F);
+    const auto zero = _mm_setzero_si128();
+
+    __m128i lowTables[3]{};
+    __m128i highTables[3]{};
+    for (std::size_t i = 0; i < maskLength; ++i)
+    {
+        lowTables[i] =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(low + i * kBlock));
+        highTables[i] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(high + i * kBlock));
+    }
+
+    auto start = from;
+    for (; start + kBlock + maskLength - 1 <= haystack.size(); start += kBlock)
+    {
+        auto result = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (std::size_t i = 0; i < maskLength; ++i)
+        {
+            const auto block = _mm_loadu_si128(
+              reinterpret_cast<const __m128i*>(haystack.data() + start + i));
+
+            const auto lows = _mm_shuffle_epi8(
+              lowTables[i], _mm_and_si128(block, nibbleMask));
+            const auto highs = _mm_shuffle_epi8(
+              highTables[i],
+              _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask));
+            result = _mm_and_si128(result, _mm_and_si128(lows, highs));
+        }
+
+        const auto empty = _mm_movemask_epi8(_mm_cmpeq_epi8(result, zero));
+        if (empty != 0xFFFF)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buckets), result);
+            return start;
+        }
+    }
+
+    return start;
+}
+
+#endif
+
+} // namespace
+
+Teddy::Teddy(std::vector<std::string> literals)
+  : mLiterals{ std::move(literals) }
+{
+    // Literals sharing their first bytes share a bucket, so they add fewer
+    // nibbles to its fingerprint
+    std::sort(mLiterals.begin(), mLiterals.end());
+
+    mMaskLength = kMaxMaskLength;
+    for (const auto& literal : mLiterals)
+    {
+        mMaskLength = std::min(mMaskLength, literal.size());
+    }
+
+    for (std::size_t i = 0; i < mLiterals.size(); ++i)
+    {
+        const auto bucket = i * kBuckets / mLiterals.size();
+        mBuckets[bucket].push_back(i);
+
+        const auto bit = static_cast<uint8_t>(1U << bucket);
+        for (std::size_t j = 0; j < mMaskLength; ++j)
+        {
+            const auto byte = static_cast<unsigned char>(mLiterals[i][j]);
+            mLow[j * kNibbles + byte % kNibbles] |= bit;
+            mHigh[j * kNibbles + byte / kNibbles] |= bit;
+        }
+    }
+}
+
+uint8_t Teddy::candidates(std::string_view haystack,
+                          std::size_t position) const
+{
+    uint8_t buckets = 0xFF;
+    for (std::size_t j = 0; j < mMaskLength; ++j)
+    {
+        const auto byte = static_cast<unsigned char>(haystack[position + j]);
+        buckets &= static_cast<uint8_t>(mLow[j * kNibbles + byte % kNibbles] &
+                                        mHigh[j * kNibbles + byte / kNibbles]);
+    }
+    return buckets;
+}
+
+bool Teddy::verify(std::string_view haystack,
+                   std::size_t position,
+                   uint8_t buckets) const
+{
+    for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+    {
+        if ((buckets & (1U << bucket)) == 0)
+        {
+            continue;
+        }
+
+        for (const auto index : mBuckets[bucket])
+        {
+            const auto& literal = mLiterals[index];
+            if (position + literal.size() <= haystack.size() &&
+                std::memcmp(haystack.data() + position,
+                            literal.data(),
+                            literal.size()) == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+std::size_t Teddy::find(std::string_view haystack) const
+{
+    std::size_t position = 0;
+
+#if defined(REGEX_SSSE3_KERNELS)
+    if (hasSsse3())
+    {
+        std::array<uint8_t, kBlock> buckets{};
+        while (true)
+        {
+            position = findCandidateBlock(haystack,
+                                          position,
+                                          mMaskLength,
+                                          mLow.data(),
+                                          mHigh.data(),
+                                          buckets.data());
+            if (position + kBlock + mMaskLength - 1 > haystack.size())
+            {
+                break;
+            }
+
+            for (std::size_t i = 0; i < kBlock; ++i)
+            {
+                if (buckets[i] != 0 &&
+                    verify(haystack, position + i, buckets[i]))
+                {
+                    return position + i;
+                }
+            }
+            position += kBlock;
+        }
+    }
+#endif
+
+    for (; position + mMaskLength <= haystack.size(); ++position)
+    {
+        const auto buckets = candidates(haystack, position);
+        if (buckets != 0 && verify(haystack, position, buckets))
+        {
+            return position;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+} // namespace regex
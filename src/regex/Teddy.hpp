@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace regex
+{
+
+// Finds the first occurrence of any of a few literals at once, after the
+// Teddy matcher of Hyperscan. The literals are spread over 8 buckets. Their
+// first bytes, up to three, are fingerprinted like a character class by
+// tables indexed by the low and the high nibble of a byte, with one bit per
+// bucket. 16 positions of the haystack are then checked with two shuffles
+// (pshufb) per fingerprinted byte, and only the literals of the buckets left
+// at a position are compared.
+class Teddy
+{
+public:
+    // The literals shall not be empty
+    explicit Teddy(std::vector<std::string> literals);
+
+    // The index of the first occurrence of any literal or npos
+    [[nodiscard]] std::size_t find(std::string_view haystack) const;
+
+private:
+    static constexpr std::size_t kBuckets = 8;
+    static constexpr std::size_t kMaxMaskLength = 3;
+    static constexpr std::size_t kNibbles = 16;
+
+    // The buckets that may hold a literal starting at the position
+    [[nodiscard]] uint8_t candidates(std::string_view haystack,
+                                     std::size_t position) const;
+
+    // Whether a literal of the buckets starts at the position
+    [[nodiscard]] bool verify(std::string_view haystack,
+                              std::size_t position,
+                              uint8_t buckets) const;
+
+    std::vector<std::string> mLiterals;
+
+    // The indices of the literals in every bucket
+    std::array<std::vector<std::size_t>, kBuckets> mBuckets;
+
+    // The number of leading bytes fingerprinted, at most the length of the
+    // shortest literal
+    std::size_t mMaskLength;
+
+    // One table of each per fingerprinted byte. Bit b of entry n is set if
+    // a literal of bucket b has a byte with n as its low or high nibble.
+    std::array<uint8_t, kMaxMaskLength * kNibbles> mLow{};
+    std::array<uint8_t, kMaxMaskLength * kNibbles> mHigh{};
+};
+
+} // namespace regex
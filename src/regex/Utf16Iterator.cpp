@@ -0,0 +1,119 @@
+#include "Utf16Iterator.hpp"
+
+namespace regex
+{
+
+const char16_t kSurrogateMask = 0xFC00;
+const char16_t kHighSurrogate = 0xD800;
+const char16_t kLowSurrogate = 0xDC00;
+const CodePoint kSupplementaryPlane = 0x10000;
+
+namespace
+{
+
+bool isHighSurrogate(char16_t unit)
+{
+    return (unit & kSurrogateMask) == kHighSurrogate;
+}
+
+bool isLowSurrogate(char16_t unit)
+{
+    return (unit & kSurrogateMask) == kLowSurrogate;
+}
+
+}
+
+Utf16Iterator::Utf16Iterator(std::u16string::const_iterator it,
+                             std::u16string::const_iterator begin,
+                             std::u16string::const_iterator end)
+  : mStringIterator(it)
+  , mBegin(begin)
+  , mEnd(end)
+{
+}
+
+bool Utf16Iterator::isPairAt(std::u16string::const_iterator it) const
+{
+    return isHighSurrogate(*it) && it + 1 != mEnd &&
+           isLowSurrogate(*(it + 1));
+}
+
+Utf16Iterator& Utf16Iterator::operator++()
+{
+    mStringIterator += isPairAt(mStringIterator) ? 2 : 1;
+
+    return *this;
+}
+
+Utf16Iterator Utf16Iterator::operator++(int)
+{
+    Utf16Iterator temp = *this;
+    ++(*this);
+    return temp;
+}
+
+Utf16Iterator& Utf16Iterator::operator--()
+{
+    --mStringIterator;
+
+    if (mStringIterator != mBegin && isPairAt(mStringIterator - 1))
+    {
+        --mStringIterator;
+    }
+
+    return *this;
+}
+
+Utf16Iterator Utf16Iterator::operator--(int)
+{
+    Utf16Iterator temp = *this;
+    --(*this);
+    return temp;
+}
+
+CodePoint Utf16Iterator::operator*() const
+{
+    const char16_t firstUnit = *mStringIterator;
+
+    if (!isPairAt(mStringIterator))
+    {
+        return static_cast<CodePoint>(firstUnit);
+    }
+
+    const char16_t secondUnit = *(mStringIterator + 1);
+    return kSupplementaryPlane +
+           (static_cast<CodePoint>(firstUnit - kHighSurrogate) << 10U) +
+           static_cast<CodePoint>(secondUnit - kLowSurrogate);
+}
+
+bool Utf16Iterator::operator==(const Utf16Iterator& rhs) const
+{
+    return mStringIterator == rhs.mStringIterator;
+}
+
+bool Utf16Iterator::operator!=(const Utf16Iterator& rhs) const
+{
+    return mStringIterator != rhs.mStringIterator;
+}
+
+bool Utf16Iterator::operator==(std::u16string::iterator rhs) const
+{
+    return mStringIterator == rhs;
+}
+
+bool Utf16Iterator::operator==(std::u16string::const_iterator rhs) const
+{
+    return mStringIterator == rhs;
+}
+
+bool Utf16Iterator::operator!=(std::u16string::iterator rhs) const
+{
+    return mStringIterator != rhs;
+}
+
+bool Utf16Iterator::operator!=(std::u16string::const_iterator rhs) const
+{
+    return mStringIterator != rhs;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CodePoint.hpp"
+#include <string>
+
+namespace regex
+{
+
+// Decodes utf-16 code units into code points, mirroring Utf8Iterator.
+//
+// A high surrogate followed by a low one is decoded as a pair. Unpaired
+// surrogates, such as a high surrogate at the end of the string, are
+// decoded as code points of their own.
+
+class Utf16Iterator
+{
+public:
+    // iterator traits
+    using difference_type = std::u16string::difference_type;
+    using value_type = CodePoint;
+    using pointer = const CodePoint*;
+    using reference = const CodePoint&;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    // The iterator shall lie within the string from begin to end
+    Utf16Iterator(std::u16string::const_iterator it,
+                  std::u16string::const_iterator begin,
+                  std::u16string::const_iterator end);
+
+    Utf16Iterator& operator++();
+    Utf16Iterator operator++(int);
+    Utf16Iterator& operator--();
+    Utf16Iterator operator--(int);
+
+    CodePoint operator*() const;
+
+    bool operator==(const Utf16Iterator& rhs) const;
+    bool operator!=(const Utf16Iterator& rhs) const;
+
+    bool operator==(std::u16string::iterator rhs) const;
+    bool operator==(std::u16string::const_iterator rhs) const;
+    bool operator!=(std::u16string::iterator rhs) const;
+    bool operator!=(std::u16string::const_iterator rhs) const;
+
+private:
+    // Whether the unit at the iterator starts a surrogate pair
+    bool isPairAt(std::u16string::const_iterator it) const;
+
+    std::u16string::const_iterator mStringIterator;
+    std::u16string::const_iterator mBegin;
+    std::u16string::const_iterator mEnd;
+};
+
+}
@@ -155,6 +155,11 @@ bool Utf8Iterator::operator==(std::string::iterator rhs) const
     return mStringIterator == rhs;
 }
 
+std::string::const_iterator Utf8Iterator::base() const
+{
+    return mStringIterator;
+}
+
 bool Utf8Iterator::operator==(std::string::const_iterator rhs) const
 {
     return mStringIterator == rhs;
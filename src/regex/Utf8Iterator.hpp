@@ -32,6 +32,9 @@ public:
 
     CodePoint operator*() const;
 
+    // The position in the underlying string
+    std::string::const_iterator base() const;
+
     bool operator==(const Utf8Iterator& rhs) const;
     bool operator!=(const Utf8Iterator& rhs) const;
 
@@ -39,6 +39,31 @@ SCENARIO("Alphabet utilities")
                                       { 125, 254 },
                                       { 255, 255 } })));
     }
+
+    SECTION("merge overlapping and adjacent intervals")
+    {
+        auto myRanges = Alphabet{ { 10, 12 }, { 0, 3 },  { 4, 5 },
+                                  { 11, 20 }, { 13, 14 }, { 30, 30 } };
+        merge(myRanges);
+        CHECK((myRanges == Alphabet({ { 0, 5 }, { 10, 20 }, { 30, 30 } })));
+    }
+
+    SECTION("negate overlapping intervals")
+    {
+        auto myRanges = Alphabet{ { 4, 8 }, { 2, 5 } };
+        negate(myRanges, 0, 255);
+        CHECK((myRanges == Alphabet({ { 0, 1 }, { 9, 255 } })));
+    }
+
+    SECTION("find the interval containing a code point")
+    {
+        const auto myRanges = Alphabet{ { 0, 9 }, { 10, 10 }, { 11, 255 } };
+        CHECK(findInterval(myRanges, 0) == 0);
+        CHECK(findInterval(myRanges, 9) == 0);
+        CHECK(findInterval(myRanges, 10) == 1);
+        CHECK(findInterval(myRanges, 11) == 2);
+        CHECK(findInterval(myRanges, 255) == 2);
+    }
 }
 
 } // namespace
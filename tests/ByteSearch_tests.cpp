@@ -0,0 +1,95 @@
+#include "ByteSearch.hpp"
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace regex
+{
+namespace
+{
+
+ByteSet makeSet(const std::string& bytes)
+{
+    ByteSet set;
+    for (const auto byte : bytes)
+    {
+        set.Bytes[set.Count++] = static_cast<unsigned char>(byte);
+    }
+    return set;
+}
+
+SCENARIO("Find any of a few bytes")
+{
+    // Longer than a block so that both the blocks and the tail are scanned
+    const std::string haystack = std::string(40, 'x') + "a" +
+                                 std::string(7, 'x') + "\"b\xff";
+
+    SECTION("One, two and three bytes")
+    {
+        CHECK(findAnyByte(haystack, 0, makeSet("a")) == 40);
+        CHECK(findAnyByte(haystack, 0, makeSet("\"b")) == 48);
+        CHECK(findAnyByte(haystack, 0, makeSet("b\"a")) == 40);
+        CHECK(findAnyByte(haystack, 0, makeSet("\xff")) == 50);
+        CHECK(findAnyByte(haystack, 0, makeSet("\xff" "c")) == 50);
+    }
+
+    SECTION("The search starts at from")
+    {
+        CHECK(findAnyByte(haystack, 40, makeSet("a")) == 40);
+        CHECK(findAnyByte(haystack, 41, makeSet("ab")) == 49);
+        CHECK(findAnyByte(haystack, 49, makeSet("ab\"")) == 49);
+    }
+
+    SECTION("Bytes that do not occur give the size")
+    {
+        CHECK(findAnyByte(haystack, 0, makeSet("c")) == haystack.size());
+        CHECK(findAnyByte(haystack, 0, makeSet("cd")) == haystack.size());
+        CHECK(findAnyByte(haystack, 41, makeSet("ac")) == haystack.size());
+        CHECK(findAnyByte(haystack, haystack.size(), makeSet("x")) ==
+              haystack.size());
+        CHECK(findAnyByte("", 0, makeSet("xy")) == 0);
+    }
+}
+
+SCENARIO("Find a pair of bytes")
+{
+    // Longer than a block so that both the blocks and the tail are scanned
+    const std::string haystack = std::string(15, 'x') + "ab" +
+                                 std::string(20, 'x') + "a\xff" + "xxb";
+
+    // Every start up to last has both offsets within the haystack
+    const auto last = [&haystack](std::size_t offset)
+    { return haystack.size() - 1 - offset; };
+
+    SECTION("Adjacent and distant bytes")
+    {
+        const auto adjacent = BytePair{ { 'a', 'b' }, { 0, 1 } };
+        CHECK(findBytePair(haystack, 0, last(1), adjacent) == 15);
+
+        const auto distant = BytePair{ { 'a', 'b' }, { 0, 4 } };
+        CHECK(findBytePair(haystack, 0, last(4), distant) == 37);
+
+        const auto reversed = BytePair{ { 0xFF, 'a' }, { 1, 0 } };
+        CHECK(findBytePair(haystack, 0, last(1), reversed) == 37);
+    }
+
+    SECTION("The search starts at from")
+    {
+        const auto adjacent = BytePair{ { 'a', 'b' }, { 0, 1 } };
+        CHECK(findBytePair(haystack, 15, last(1), adjacent) == 15);
+        CHECK(findBytePair(haystack, 16, last(1), adjacent) == last(1) + 1);
+    }
+
+    SECTION("Pairs that do not occur give last + 1")
+    {
+        const auto missing = BytePair{ { 'b', 'a' }, { 0, 1 } };
+        CHECK(findBytePair(haystack, 0, last(1), missing) == last(1) + 1);
+
+        // only one of the bytes is at its offset
+        const auto half = BytePair{ { 'a', 'x' }, { 0, 1 } };
+        CHECK(findBytePair(haystack, 0, last(1), half) == last(1) + 1);
+    }
+}
+
+} // namespace
+} // namespace regex
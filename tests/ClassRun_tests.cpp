@@ -0,0 +1,76 @@
+#include "ClassRun.hpp"
+#include "Parser.hpp"
+#include "Simplifier.hpp"
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace regex
+{
+namespace
+{
+
+std::optional<ClassRun> classRun(const std::string& regex,
+                                 Mode mode = Mode::eUtf8)
+{
+    return findClassRun(ast::simplify(parser::Parser(regex, mode).parse()));
+}
+
+SCENARIO("Find class runs")
+{
+    SECTION("A class alone or repeated")
+    {
+        CHECK(classRun("[0-9]+"));
+        CHECK(classRun("[A-Za-z0-9_-]{1,64}"));
+        CHECK(classRun("[^\\s]*"));
+        CHECK(classRun("[a-z]"));
+    }
+
+    SECTION("Other shapes and classes without ASCII members")
+    {
+        CHECK(!classRun("[0-9]+a"));
+        CHECK(!classRun("[0-9]+|[a-z]+"));
+        CHECK(!classRun("(ab)+"));
+        CHECK(!classRun("[é-ÿ]+"));
+    }
+}
+
+SCENARIO("Match class runs")
+{
+    using Verdict = ClassRun::Verdict;
+
+    // Long enough for both the blocks and the tail
+    const auto digits = std::string(40, '7');
+
+    SECTION("Every byte is checked")
+    {
+        const auto run = *classRun("[0-9]+");
+        CHECK(run.match(digits) == Verdict::eMatch);
+        CHECK(run.match("0") == Verdict::eMatch);
+        CHECK(run.match("") == Verdict::eNoMatch);
+        CHECK(run.match(digits + "a") == Verdict::eNoMatch);
+        CHECK(run.match("a" + digits) == Verdict::eNoMatch);
+        CHECK(run.match(digits + "/" + digits) == Verdict::eNoMatch);
+        CHECK(run.match(digits + ":") == Verdict::eNoMatch);
+    }
+
+    SECTION("The count is bounded")
+    {
+        const auto run = *classRun("[0-9]{3,40}");
+        CHECK(run.match("12") == Verdict::eNoMatch);
+        CHECK(run.match("123") == Verdict::eMatch);
+        CHECK(run.match(digits) == Verdict::eMatch);
+        CHECK(run.match(digits + "1") == Verdict::eNoMatch);
+    }
+
+    SECTION("Characters beyond ASCII are left to the automaton")
+    {
+        const auto run = *classRun("[^\\s]+");
+        CHECK(run.match(digits + "é") == Verdict::eUnknown);
+        CHECK(run.match(digits + " é") == Verdict::eNoMatch);
+        CHECK(run.match("\x7f") == Verdict::eMatch);
+    }
+}
+
+} // namespace
+} // namespace regex
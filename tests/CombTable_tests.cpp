@@ -0,0 +1,67 @@
+#include "CombTable.hpp"
+#include "MakeDFA.hpp"
+#include <catch2/catch.hpp>
+
+namespace automata
+{
+namespace
+{
+
+// Compares the comb with the DFA on every state and input
+template<typename Id, typename Class>
+bool isEquivalent(const CombTable<Id, Class>& comb, const DFA& dfa)
+{
+    for (StateId state = 0; state < dfa.stateCount(); ++state)
+    {
+        const auto id = static_cast<Id>(state);
+        if (comb.isSink(id) != (state < dfa.sinkCount()) ||
+            comb.isFinal(id) != dfa.isFinalState(state))
+        {
+            return false;
+        }
+
+        for (std::size_t input = 0; input < dfa.inputCount(); ++input)
+        {
+            if (comb.step(id, static_cast<Class>(input)) !=
+                dfa.step(state, static_cast<InputType>(input)))
+            {
+                return false;
+            }
+        }
+    }
+
+    return comb.start() == dfa.getStartState();
+}
+
+SCENARIO("Compress a DFA into a comb")
+{
+    SECTION("Literal")
+    {
+        const auto dfa = makeDFA("hello");
+        CHECK(isEquivalent(CombTable<uint8_t, uint8_t>(dfa), dfa));
+    }
+
+    SECTION("Alternation of literals sharing inputs")
+    {
+        const auto dfa = makeDFA("cat|cart|dog|do[a-f]+|[^a-z]z");
+        CHECK(isEquivalent(CombTable<uint16_t, uint8_t>(dfa), dfa));
+    }
+
+    SECTION("Dense rows")
+    {
+        const auto dfa = makeDFA("(a|b|c)*a(a|b|c){4}");
+        CHECK(isEquivalent(CombTable<uint32_t, uint16_t>(dfa), dfa));
+    }
+
+    SECTION("Sparse rows take less space than the dense table")
+    {
+        const auto dfa = makeDFA("abcdefghijklmnopqrstuvwxyz");
+        const auto comb = CombTable<uint16_t, uint8_t>(dfa);
+        CHECK(isEquivalent(comb, dfa));
+        CHECK(comb.bytes() <
+              dfa.stateCount() * dfa.inputCount() * sizeof(uint16_t));
+    }
+}
+
+} // namespace
+} // namespace automata
@@ -0,0 +1,51 @@
+#include "DFA.hpp"
+#include "MakeDFA.hpp"
+#include <catch2/catch.hpp>
+
+namespace automata
+{
+namespace
+{
+
+SCENARIO("Trim the DFA")
+{
+    SECTION("The dead state comes first")
+    {
+        const auto dfa = makeDFA("abc");
+        CHECK(dfa.stateCount() == 5);
+        CHECK(dfa.sinkCount() == 1);
+        CHECK(!dfa.isFinalState(0));
+        CHECK(dfa.getStartState() == 1);
+    }
+
+    SECTION("The accepting sink follows the dead state")
+    {
+        const auto dfa = makeDFA("abc[\\x00-\\U0010ffff]*");
+        CHECK(dfa.stateCount() == 5);
+        CHECK(dfa.sinkCount() == 2);
+        CHECK(!dfa.isFinalState(0));
+        CHECK(dfa.isFinalState(1));
+        CHECK(dfa.getStartState() == 2);
+    }
+
+    SECTION("There is no dead state when every input is accepted")
+    {
+        const auto dfa = makeDFA("[\\x00-\\U0010ffff]*");
+        CHECK(dfa.stateCount() == 1);
+        CHECK(dfa.sinkCount() == 1);
+        CHECK(dfa.isFinalState(0));
+        CHECK(dfa.getStartState() == 0);
+    }
+
+    SECTION("The start state is dead when nothing is accepted")
+    {
+        const auto dfa = makeDFA("a[^\\x00-\\U0010ffff]");
+        CHECK(dfa.stateCount() == 1);
+        CHECK(dfa.sinkCount() == 1);
+        CHECK(!dfa.isFinalState(0));
+        CHECK(dfa.getStartState() == 0);
+    }
+}
+
+} // namespace
+} // namespace automata
@@ -0,0 +1,122 @@
+#include "Literals.hpp"
+#include "Parser.hpp"
+#include "Simplifier.hpp"
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+namespace regex::ast
+{
+namespace
+{
+
+Literals extracted(const std::string& regex)
+{
+    return extractLiterals(simplify(parser::Parser(regex).parse()));
+}
+
+SCENARIO("Extract the literals of every match")
+{
+    SECTION("Literal")
+    {
+        const auto literals = extracted("ERROR");
+        CHECK(literals.IsExact);
+        CHECK(literals.Prefix == U"ERROR");
+        CHECK(literals.Suffix == U"ERROR");
+        CHECK(literals.Required == U"ERROR");
+    }
+
+    SECTION("Literal surrounded by repetitions")
+    {
+        const auto literals = extracted("[0-9]+ user_id=[0-9]+");
+        CHECK(!literals.IsExact);
+        CHECK(literals.Prefix.empty());
+        CHECK(literals.Suffix.empty());
+        CHECK(literals.Required == U" user_id=");
+    }
+
+    SECTION("Common prefix and suffix of alternatives")
+    {
+        const auto literals = extracted("abcx|abdx");
+        CHECK(!literals.IsExact);
+        CHECK(literals.Prefix == U"ab");
+        CHECK(literals.Suffix == U"x");
+        CHECK(literals.Required == U"ab");
+    }
+
+    SECTION("Literal spanning the boundary of a group")
+    {
+        const auto literals = extracted("[a-z]*(xy)z[0-9]");
+        CHECK(literals.Required == U"xyz");
+    }
+
+    SECTION("Mandatory repetitions")
+    {
+        CHECK(extracted("(ab){3}").IsExact);
+        CHECK(extracted("(ab){3}").Prefix == U"ababab");
+        CHECK(extracted("(ab){2,}c").Prefix == U"abab");
+        CHECK(extracted("(ab){2,}c").Suffix == U"ababc");
+    }
+
+    SECTION("Optional parts require nothing")
+    {
+        const auto literals = extracted("(abc)?");
+        CHECK(!literals.IsExact);
+        CHECK(literals.Required.empty());
+    }
+
+    SECTION("Long literals are cut")
+    {
+        const auto literals = extracted("a{100}");
+        CHECK(!literals.IsExact);
+        CHECK(literals.Prefix.size() == kMaxLiteralLength);
+        CHECK(literals.Suffix.size() == kMaxLiteralLength);
+    }
+
+    SECTION("Distance of the required literal from the start")
+    {
+        const auto field = extracted("user_id=[0-9]+ ");
+        CHECK(field.Required == U"user_id=");
+        CHECK(field.RequiredOffset == 0);
+        CHECK(!field.MaxLength);
+
+        const auto code = extracted("[0-9]{1,5} ERROR");
+        CHECK(code.Required == U" ERROR");
+        CHECK(code.RequiredOffset == 5);
+        CHECK(code.MaxLength == 11);
+
+        const auto alternatives = extracted("(a|bc)xyz");
+        CHECK(alternatives.Required == U"xyz");
+        CHECK(alternatives.RequiredOffset == 2);
+
+        CHECK(!extracted("[0-9]+ user_id=").RequiredOffset);
+    }
+
+    SECTION("One of the literals of alternatives is required")
+    {
+        auto methods = extracted("GET|POST|PUT|DELETE");
+        std::sort(methods.RequiredAny.begin(), methods.RequiredAny.end());
+        CHECK(methods.IsExactAny);
+        CHECK(methods.Required.empty());
+        CHECK(methods.RequiredAny == std::vector<std::u32string>{
+                                       U"DELETE", U"GET", U"POST", U"PUT" });
+
+        auto levels = extracted("(FATAL|ERROR): [a-z]+");
+        std::sort(levels.RequiredAny.begin(), levels.RequiredAny.end());
+        CHECK(!levels.IsExactAny);
+        CHECK(levels.Required == U": ");
+        CHECK(levels.RequiredAny ==
+              std::vector<std::u32string>{ U"ERROR: ", U"FATAL: " });
+    }
+
+    SECTION("Optional alternatives require no literal")
+    {
+        CHECK(extracted("(GET|POST)?").RequiredAny.empty());
+        CHECK(extracted("GET|[a-z]").RequiredAny.empty());
+        CHECK(!extracted("(GET|POST)+").IsExactAny);
+        CHECK(extracted("(GET|POST)+").RequiredAny.size() == 2);
+    }
+}
+
+} // namespace
+} // namespace regex::ast
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "DFA.hpp"
+#include "NFA.hpp"
+#include "Parser.hpp"
+
+#include <string>
+
+namespace automata
+{
+
+// The minimized and trimmed DFA of the regex, without simplifying its AST
+inline DFA makeDFA(const std::string& regex)
+{
+    const auto ast = regex::parser::Parser(regex).parse();
+    return ast.makeNFA(ast.makeAlphabet()).makeDFA();
+}
+
+} // namespace automata
@@ -0,0 +1,56 @@
+#include "Matcher.hpp"
+#include "Parser.hpp"
+#include "Simplifier.hpp"
+#include <catch2/catch.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <variant>
+
+namespace regex
+{
+namespace
+{
+
+template<typename Table>
+bool isMatchedWith(const std::string& regex)
+{
+    const auto matcher =
+      Matcher(ast::simplify(parser::Parser(regex).parse()), Mode::eUtf8);
+    return std::holds_alternative<Table>(matcher.table());
+}
+
+SCENARIO("Pick the narrowest table")
+{
+    SECTION("Offsets fit into 8 bits")
+    {
+        CHECK(isMatchedWith<DFATable<uint8_t, uint8_t>>("ab"));
+    }
+
+    SECTION("Offsets fit into 16 bits")
+    {
+        CHECK(isMatchedWith<DFATable<uint16_t, uint8_t>>("(a|b)*a(a|b){5}"));
+    }
+
+    SECTION("Dense rows stay in a table of 32 bit offsets")
+    {
+        // 2^15 states, none of them sparse enough for a comb to be smaller
+        CHECK(isMatchedWith<DFATable<uint32_t, uint8_t>>("(a|b)*a(a|b){14}"));
+    }
+
+    SECTION("Sparse rows with more than 256 inputs are packed into a comb")
+    {
+        std::stringstream pattern;
+        pattern << std::hex << std::setfill('0');
+        for (uint32_t c = 0x100; c < 0x100 + 300; ++c)
+        {
+            pattern << "\\u" << std::setw(4) << c;
+        }
+
+        CHECK(isMatchedWith<CombTable<uint16_t, uint16_t>>(pattern.str()));
+    }
+}
+
+} // namespace
+} // namespace regex
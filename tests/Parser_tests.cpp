@@ -333,6 +333,64 @@ SCENARIO("Parse character from 8 digit unicode code point")
     }
 }
 
+SCENARIO("Parse character from 2 digit hexadecimal code point")
+{
+    SECTION("Hexadecimal code point mixed digits")
+    {
+        const std::string regex = "\\x7e\\xE9";
+        auto parser = Parser(regex);
+        auto ast = parser.parse();
+        CHECK(ast.print() ==
+              "([\\U0000007e-\\U0000007e][\\U000000e9-\\U000000e9])");
+    }
+
+    SECTION("Throw on incomplete 2 digit hexadecimal codepoint")
+    {
+        const std::string regex = GENERATE("\\x", "\\x1", "\\x1g");
+        auto parser = Parser(regex);
+        REQUIRE_THROWS_WITH(
+          parser.parse(), Contains("The hexadecimal codepoint is incomplete"));
+    }
+}
+
+SCENARIO("Parse in byte mode")
+{
+    SECTION("Bytes are not decoded as utf-8")
+    {
+        const std::string regex = "\xC3\xA9";
+        auto parser = Parser(regex, Mode::eBytes);
+        auto ast = parser.parse();
+        CHECK(ast.print() ==
+              "([\\U000000c3-\\U000000c3][\\U000000a9-\\U000000a9])");
+    }
+
+    SECTION("Any character is limited to the byte range")
+    {
+        const std::string regex = ".";
+        auto parser = Parser(regex, Mode::eBytes);
+        auto ast = parser.parse();
+        CHECK(ast.print() ==
+              "[\\U00000000-\\U00000009\\U0000000b-\\U000000ff]");
+    }
+
+    SECTION("Negated character class is limited to the byte range")
+    {
+        const std::string regex = "[^a]";
+        auto parser = Parser(regex, Mode::eBytes);
+        auto ast = parser.parse();
+        CHECK(ast.print() ==
+              "[\\U00000000-\\U00000060\\U00000062-\\U000000ff]");
+    }
+
+    SECTION("Throw when unicode codepoint exceeds the byte range")
+    {
+        const std::string regex = GENERATE("\\u0100", "\\U00000100");
+        auto parser = Parser(regex, Mode::eBytes);
+        REQUIRE_THROWS_WITH(parser.parse(),
+                            Contains("The codepoint exceeds the byte range"));
+    }
+}
+
 SCENARIO("Parse any (.) character")
 {
     SECTION("Any character .")
@@ -341,7 +399,7 @@ SCENARIO("Parse any (.) character")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U00000009]|[\\U0000000b-\\U0010ffff])");
+              "[\\U00000000-\\U00000009\\U0000000b-\\U0010ffff]");
     }
 }
 
@@ -361,7 +419,7 @@ SCENARIO("Parse shorthand character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U0000002f]|[\\U0000003a-\\U0010ffff])");
+              "[\\U00000000-\\U0000002f\\U0000003a-\\U0010ffff]");
     }
 
     SECTION("Word character")
@@ -370,8 +428,8 @@ SCENARIO("Parse shorthand character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000030-\\U00000039]|([\\U00000041-\\U0000005a]|(["
-              "\\U0000005f-\\U0000005f]|[\\U00000061-\\U0000007a])))");
+              "[\\U00000030-\\U00000039\\U00000041-\\U0000005a\\U0000005f-"
+              "\\U0000005f\\U00000061-\\U0000007a]");
     }
 
     SECTION("Negated word character")
@@ -380,9 +438,8 @@ SCENARIO("Parse shorthand character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U0000002f]|([\\U0000003a-\\U00000040]|(["
-              "\\U0000005b-\\U0000005e]|([\\U00000060-\\U00000060]|["
-              "\\U0000007b-\\U0010ffff]))))");
+              "[\\U00000000-\\U0000002f\\U0000003a-\\U00000040\\U0000005b-"
+              "\\U0000005e\\U00000060-\\U00000060\\U0000007b-\\U0010ffff]");
     }
 
     SECTION("White space character")
@@ -391,7 +448,7 @@ SCENARIO("Parse shorthand character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000009-\\U0000000d]|[\\U00000020-\\U00000020])");
+              "[\\U00000009-\\U0000000d\\U00000020-\\U00000020]");
     }
 
     SECTION("Negated white space character")
@@ -399,8 +456,9 @@ SCENARIO("Parse shorthand character classes")
         const std::string regex = "\\S";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000000-\\U00000008]|([\\U0000000e-"
-                             "\\U0000001f]|[\\U00000021-\\U0010ffff]))");
+        CHECK(ast.print() ==
+              "[\\U00000000-\\U00000008\\U0000000e-\\U0000001f\\U00000021-"
+              "\\U0010ffff]");
     }
 }
 
@@ -411,8 +469,7 @@ SCENARIO("Parse character classes")
         const std::string regex = "[abc]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U00000061]|([\\U00000062-"
-                             "\\U00000062]|[\\U00000063-\\U00000063]))");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]");
     }
 
     SECTION("Negated character class")
@@ -421,7 +478,7 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U00000060]|[\\U00000064-\\U0010ffff])");
+              "[\\U00000000-\\U00000060\\U00000064-\\U0010ffff]");
     }
 
     SECTION("Character class with shorthand \\w")
@@ -430,8 +487,8 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000030-\\U00000039]|([\\U00000041-\\U0000005a]|(["
-              "\\U0000005f-\\U0000005f]|[\\U00000061-\\U0000007a])))");
+              "[\\U00000030-\\U00000039\\U00000041-\\U0000005a\\U0000005f-"
+              "\\U0000005f\\U00000061-\\U0000007a]");
     }
 
     SECTION("Character class with shorthand \\W")
@@ -440,9 +497,8 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U0000002f]|([\\U0000003a-\\U00000040]|(["
-              "\\U0000005b-\\U0000005e]|([\\U00000060-\\U00000060]|["
-              "\\U0000007b-\\U0010ffff]))))");
+              "[\\U00000000-\\U0000002f\\U0000003a-\\U00000040\\U0000005b-"
+              "\\U0000005e\\U00000060-\\U00000060\\U0000007b-\\U0010ffff]");
     }
 
     SECTION("Negated character class with \\w and \\W")
@@ -467,7 +523,7 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000000-\\U0000002f]|[\\U0000003a-\\U0010ffff])");
+              "[\\U00000000-\\U0000002f\\U0000003a-\\U0010ffff]");
     }
 
     SECTION("Negated character class with \\d and \\D")
@@ -484,7 +540,7 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000009-\\U0000000d]|[\\U00000020-\\U00000020])");
+              "[\\U00000009-\\U0000000d\\U00000020-\\U00000020]");
     }
 
     SECTION("Character class with shorthand \\S")
@@ -492,8 +548,9 @@ SCENARIO("Parse character classes")
         const std::string regex = "[\\S]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000000-\\U00000008]|([\\U0000000e-"
-                             "\\U0000001f]|[\\U00000021-\\U0010ffff]))");
+        CHECK(ast.print() ==
+              "[\\U00000000-\\U00000008\\U0000000e-\\U0000001f\\U00000021-"
+              "\\U0010ffff]");
     }
 
     SECTION("Negated character class with \\s and \\S")
@@ -509,11 +566,9 @@ SCENARIO("Parse character classes")
         const std::string regex = "[\\n\\f\\r\\t\\v\\a\\\\]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(
-          ast.print() ==
-          "([\\U0000000a-\\U0000000a]|([\\U0000000c-\\U0000000c]|([\\U0000000d-"
-          "\\U0000000d]|([\\U00000009-\\U00000009]|([\\U0000000b-\\U0000000b]|("
-          "[\\U00000007-\\U00000007]|[\\U0000005c-\\U0000005c]))))))");
+        CHECK(ast.print() ==
+              "[\\U00000007-\\U00000007\\U00000009-\\U0000000d\\U0000005c-"
+              "\\U0000005c]");
     }
 
     SECTION("Character class with escaped meta characters")
@@ -522,8 +577,8 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U0000005e-\\U0000005e]|([\\U0000005d-\\U0000005d]|(["
-              "\\U0000005b-\\U0000005b]|[\\U0000002d-\\U0000002d])))");
+              "[\\U0000002d-\\U0000002d\\U0000005b-\\U0000005b\\U0000005d-"
+              "\\U0000005e]");
     }
 
     SECTION("Character class with characters that are considered meta "
@@ -532,11 +587,9 @@ SCENARIO("Parse character classes")
         const std::string regex = "[$*+?.()]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(
-          ast.print() ==
-          "([\\U00000024-\\U00000024]|([\\U0000002a-\\U0000002a]|([\\U0000002b-"
-          "\\U0000002b]|([\\U0000003f-\\U0000003f]|([\\U0000002e-\\U0000002e]|("
-          "[\\U00000028-\\U00000028]|[\\U00000029-\\U00000029]))))))");
+        CHECK(ast.print() ==
+              "[\\U00000024-\\U00000024\\U00000028-\\U0000002b\\U0000002e-"
+              "\\U0000002e\\U0000003f-\\U0000003f]");
     }
 
     SECTION("Character class with unicode code point (4 digits)")
@@ -569,7 +622,7 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U0000002d-\\U0000002d]|[\\U00000061-\\U00000061])");
+              "[\\U0000002d-\\U0000002d\\U00000061-\\U00000061]");
     }
 
     SECTION("Character class where hyphen is final character")
@@ -578,7 +631,7 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000061-\\U00000061]|[\\U0000002d-\\U0000002d])");
+              "[\\U0000002d-\\U0000002d\\U00000061-\\U00000061]");
     }
 
     SECTION("Character class where hyphen is treated literally because it is "
@@ -587,9 +640,7 @@ SCENARIO("Parse character classes")
         const std::string regex = "[\\d-\\D]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() ==
-              "([\\U00000030-\\U00000039]|([\\U0000002d-\\U0000002d]|(["
-              "\\U00000000-\\U0000002f]|[\\U0000003a-\\U0010ffff])))");
+        CHECK(ast.print() == "[\\U00000000-\\U0010ffff]");
     }
 
     SECTION("Character class where closing bracket is first character")
@@ -629,8 +680,9 @@ SCENARIO("Parse character classes")
         const std::string regex = "[a-zA-Z0-9]";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U0000007a]|([\\U00000041-"
-                             "\\U0000005a]|[\\U00000030-\\U00000039]))");
+        CHECK(ast.print() ==
+              "[\\U00000030-\\U00000039\\U00000041-\\U0000005a\\U00000061-"
+              "\\U0000007a]");
     }
 
     SECTION("Character class with range containing a single character")
@@ -648,9 +700,8 @@ SCENARIO("Parse character classes")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "([\\U00000061-\\U0000007a]|([\\U00000058-\\U00000058]|(["
-              "\\U00000059-\\U00000059]|([\\U0000005a-\\U0000005a]|["
-              "\\U00000007-\\U00000007]))))");
+              "[\\U00000007-\\U00000007\\U00000058-\\U0000005a\\U00000061-"
+              "\\U0000007a]");
     }
 
     SECTION("Throw exception when character range is out of order")
@@ -787,6 +838,25 @@ SCENARIO("Parse group")
         CHECK(ast.print() == "[\\U00000061-\\U00000061]");
     }
 
+    SECTION("Deeply nested group")
+    {
+        const auto depth = 100000;
+        const auto regex =
+          std::string(depth, '(') + "a" + std::string(depth, ')');
+        auto parser = Parser(regex);
+        auto ast = parser.parse();
+        CHECK(ast.print() == "[\\U00000061-\\U00000061]");
+    }
+
+    SECTION("Throw when a group is closed by a bracket")
+    {
+        const std::string regex = "(a]";
+        auto parser = Parser(regex);
+        REQUIRE_THROWS_WITH(
+          parser.parse(),
+          Contains("Error at position 2. Message: Incomplete group structure"));
+    }
+
     SECTION("Non-capturing group is not supported")
     {
         const std::string regex = "(?:a)";
@@ -877,8 +947,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]*";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U00000061]|([\\U00000062-"
-                             "\\U00000062]|[\\U00000063-\\U00000063])){0,}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{0,}");
     }
 
     SECTION("Throw when token preceding Kleene star is not quantifiable ")
@@ -911,8 +980,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]+";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U00000061]|([\\U00000062-"
-                             "\\U00000062]|[\\U00000063-\\U00000063])){1,}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{1,}");
     }
 
     SECTION("Throw when token preceding Kleene plus is not quantifiable ")
@@ -945,8 +1013,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]?";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U00000061]|([\\U00000062-"
-                             "\\U00000062]|[\\U00000063-\\U00000063])){0,1}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{0,1}");
     }
 
     SECTION("Throw when token preceding optional is not quantifiable ")
@@ -979,9 +1046,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]{100}";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() ==
-              "([\\U00000061-\\U00000061]|([\\U00000062-\\U00000062]|["
-              "\\U00000063-\\U00000063])){100,100}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{100,100}");
     }
 
     SECTION("Ranged quantifier: upper bound is omitted ")
@@ -1006,8 +1071,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]{100,}";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() == "([\\U00000061-\\U00000061]|([\\U00000062-"
-                             "\\U00000062]|[\\U00000063-\\U00000063])){100,}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{100,}");
     }
 
     SECTION("Ranged quantifier: lower and upper bound ")
@@ -1032,9 +1096,7 @@ SCENARIO("Parse quantifiers")
         const std::string regex = "[abc]{100,200}";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(ast.print() ==
-              "([\\U00000061-\\U00000061]|([\\U00000062-\\U00000062]|["
-              "\\U00000063-\\U00000063])){100,200}");
+        CHECK(ast.print() == "[\\U00000061-\\U00000063]{100,200}");
     }
 
     SECTION("Throw when token preceding ranged quantifier is not quantifiable ")
@@ -1149,9 +1211,7 @@ SCENARIO("Parse concatenation")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "(([\\U00000061-\\U00000061]|([\\U00000062-\\U00000062]|["
-              "\\U00000063-\\U00000063]))([\\U00000031-\\U00000031]|(["
-              "\\U00000032-\\U00000032]|[\\U00000033-\\U00000033])))");
+              "([\\U00000061-\\U00000063][\\U00000031-\\U00000033])");
     }
 
     SECTION("Concatenation of two groups")
@@ -1241,9 +1301,7 @@ SCENARIO("Parse alternation")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "(([\\U00000061-\\U00000061]|([\\U00000062-\\U00000062]|["
-              "\\U00000063-\\U00000063]))|([\\U00000031-\\U00000031]|(["
-              "\\U00000032-\\U00000032]|[\\U00000033-\\U00000033])))");
+              "([\\U00000061-\\U00000063]|[\\U00000031-\\U00000033])");
     }
 
     SECTION("Alternation of two groups")
@@ -1261,9 +1319,9 @@ SCENARIO("Parse alternation")
         auto parser = Parser(regex);
         auto ast = parser.parse();
         CHECK(ast.print() ==
-              "((([\\U00000031-\\U00000031][\\U00000032-\\U00000032])["
-              "\\U00000033-\\U00000033])|(([\\U00000061-\\U00000061]["
-              "\\U00000062-\\U00000062])[\\U00000063-\\U00000063]))");
+              "(([\\U00000031-\\U00000031][\\U00000032-\\U00000032]["
+              "\\U00000033-\\U00000033])|([\\U00000061-\\U00000061]["
+              "\\U00000062-\\U00000062][\\U00000063-\\U00000063]))");
     }
 
     SECTION("Alternation, concatenation and character class")
@@ -1271,11 +1329,10 @@ SCENARIO("Parse alternation")
         const std::string regex = "123|[abc]|z";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(
-          ast.print() ==
-          "((([\\U00000031-\\U00000031][\\U00000032-\\U00000032])[\\U00000033-"
-          "\\U00000033])|(([\\U00000061-\\U00000061]|([\\U00000062-\\U00000062]"
-          "|[\\U00000063-\\U00000063]))|[\\U0000007a-\\U0000007a]))");
+        CHECK(ast.print() ==
+              "(([\\U00000031-\\U00000031][\\U00000032-\\U00000032]["
+              "\\U00000033-\\U00000033])|[\\U00000061-\\U00000063]|["
+              "\\U0000007a-\\U0000007a])");
     }
 
     SECTION("Alternation, concatenation and group")
@@ -1283,12 +1340,12 @@ SCENARIO("Parse alternation")
         const std::string regex = "123|(abc|xy)|z";
         auto parser = Parser(regex);
         auto ast = parser.parse();
-        CHECK(
-          ast.print() ==
-          "((([\\U00000031-\\U00000031][\\U00000032-\\U00000032])[\\U00000033-"
-          "\\U00000033])|(((([\\U00000061-\\U00000061][\\U00000062-\\U00000062]"
-          ")[\\U00000063-\\U00000063])|([\\U00000078-\\U00000078][\\U00000079-"
-          "\\U00000079]))|[\\U0000007a-\\U0000007a]))");
+        CHECK(ast.print() ==
+              "(([\\U00000031-\\U00000031][\\U00000032-\\U00000032]["
+              "\\U00000033-\\U00000033])|(([\\U00000061-\\U00000061]["
+              "\\U00000062-\\U00000062][\\U00000063-\\U00000063])|(["
+              "\\U00000078-\\U00000078][\\U00000079-\\U00000079]))|["
+              "\\U0000007a-\\U0000007a])");
     }
 }
 
@@ -0,0 +1,113 @@
+#include "Prefilter.hpp"
+#include <catch2/catch.hpp>
+
+namespace regex
+{
+namespace
+{
+
+SCENARIO("Find a literal")
+{
+    SECTION("Every byte of the needle may be the rare one")
+    {
+        const std::string haystack = "xxabxabcabcdabc";
+        for (std::size_t rare = 0; rare < 3; ++rare)
+        {
+            CHECK(findLiteral(haystack, "abc", rare) == 5);
+            CHECK(findLiteral(haystack, "abcd", rare) == 8);
+            CHECK(findLiteral(haystack, "abd", rare) == std::string::npos);
+        }
+    }
+
+    SECTION("Needles at both ends of the haystack")
+    {
+        CHECK(findLiteral("abcdef", "abc", 2) == 0);
+        CHECK(findLiteral("abcdef", "def", 0) == 3);
+        CHECK(findLiteral("abc", "abcd", 0) == std::string::npos);
+    }
+
+    SECTION("Dense candidates of the rare byte")
+    {
+        const auto haystack = std::string(200, 'a') + "b";
+        CHECK(findLiteral(haystack, "ab", 0) == 199);
+        CHECK(findLiteral(haystack, "aab", 1) == 198);
+        CHECK(findLiteral(haystack, "ac", 0) == std::string::npos);
+    }
+
+    SECTION("The empty needle is found at the start")
+    {
+        CHECK(findLiteral("abc", "", 0) == 0);
+    }
+
+    SECTION("The rarest byte is picked by frequency in text")
+    {
+        CHECK(findRarestByte("user_id=") == 7);
+        CHECK(findRarestByte("ERROR") == 0);
+    }
+}
+
+SCENARIO("Prefilter targets")
+{
+    const auto literals = ast::Literals{ U"ab", U"yz", U"klm", {}, false };
+
+    SECTION("Utf-8")
+    {
+        const auto prefilter = Prefilter(literals, Mode::eUtf8);
+        CHECK(prefilter.mayMatch("ab_klm_yz"));
+        CHECK(!prefilter.mayMatch("_ab_klm_yz"));
+        CHECK(!prefilter.mayMatch("ab_klm_yz_"));
+        CHECK(!prefilter.mayMatch("ab_kl_yz"));
+        CHECK(prefilter.maySearch("__klm__"));
+        CHECK(!prefilter.maySearch("ab_yz"));
+    }
+
+    SECTION("Multi-byte code points are utf-8 encoded")
+    {
+        const auto unicode = ast::Literals{ U"", U"", U"Ж", {}, false };
+        CHECK(Prefilter(unicode, Mode::eUtf8).maySearch("xЖx"));
+        CHECK(!Prefilter(unicode, Mode::eUtf8).maySearch("x\x16x"));
+    }
+
+    SECTION("One of a set of literals is required")
+    {
+        const auto levels =
+          ast::Literals{ U"", U"", U": ", { U"FATAL", U"ERROR" }, false };
+        const auto prefilter = Prefilter(levels, Mode::eUtf8);
+        CHECK(prefilter.maySearch("x ERROR: y"));
+        CHECK(prefilter.maySearch("x FATAL: y"));
+        CHECK(!prefilter.maySearch("x INFO: y"));
+        CHECK(!prefilter.maySearch("x ERROR y"));
+    }
+
+    SECTION("Matches start a bounded distance before the required literal")
+    {
+        auto code = ast::Literals{ U"", U"", U"abc", {}, false };
+        code.RequiredOffset = 2;
+        const auto prefilter = Prefilter(code, Mode::eUtf8);
+        CHECK(prefilter.isStartBounded());
+
+        // two code points take up to eight bytes
+        CHECK(prefilter.findRequired("xxxxxxxxxxabc", 0) == 10);
+        CHECK(prefilter.findStart("xxxxxxxxxxabc", 0, 10) == 2);
+        CHECK(prefilter.findStart("xxxabc", 0, 3) == 0);
+        CHECK(prefilter.findRequired("xxxabcabc", 4) == 6);
+        CHECK(prefilter.findStart("xxxabcabc", 4, 6) == 4);
+        CHECK(prefilter.findRequired("abcxx", 1) == std::string::npos);
+
+        // backs up to the lead byte of a character
+        CHECK(prefilter.findStart("世世世世abc", 0, 12) == 3);
+
+        CHECK(Prefilter(code, Mode::eBytes).findStart("xxxxxabc", 0, 5) == 3);
+        CHECK(!Prefilter(literals, Mode::eUtf8).isStartBounded());
+    }
+
+    SECTION("Sets less selective than the required literal are ignored")
+    {
+        const auto fields =
+          ast::Literals{ U"", U"", U" user_id=", { U"a", U"b" }, false };
+        CHECK(Prefilter(fields, Mode::eUtf8).maySearch("x user_id=1"));
+    }
+}
+
+} // namespace
+} // namespace regex
@@ -11,6 +11,8 @@ namespace regex
 namespace
 {
 
+using Catch::Matchers::Contains;
+
 SCENARIO("Match empty regex")
 {
     SECTION("Empty Regex")
@@ -423,6 +425,62 @@ SCENARIO("Match character from 8 digit unicode code point")
     }
 }
 
+SCENARIO("Match character from 2 digit hexadecimal code point")
+{
+    SECTION("Hexadecimal code point")
+    {
+        auto regex = Regex("\\xe9");
+
+        // Positive test case(s)
+        REQUIRE(regex.match("é"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(""));
+        REQUIRE(!regex.match("\xE9"));
+    }
+}
+
+SCENARIO("Match in byte mode")
+{
+    SECTION("Hexadecimal code point matches a single byte")
+    {
+        auto regex = Regex("\\xe9", Mode::eBytes);
+
+        // Positive test case(s)
+        REQUIRE(regex.match("\xE9"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(""));
+        REQUIRE(!regex.match("é"));
+    }
+
+    SECTION("Any character matches every byte but newline")
+    {
+        auto regex = Regex("..", Mode::eBytes);
+
+        // Positive test case(s)
+        REQUIRE(regex.match("é"));
+        REQUIRE(regex.match("\xFF\x80"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match("ﻚ"));
+        REQUIRE(!regex.match("\n\n"));
+    }
+
+    SECTION("Binary payload with character classes")
+    {
+        auto regex = Regex("\\x00[\\x80-\\xFF]+[^\\xFF]", Mode::eBytes);
+
+        // Positive test case(s)
+        REQUIRE(regex.match(std::string("\x00\x80\xFF\xFE", 4)));
+        REQUIRE(regex.match(std::string("\x00\x90\x00", 3)));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(std::string("\x00\x7F\x00", 3)));
+        REQUIRE(!regex.match(std::string("\x00\x80\xFF", 3)));
+    }
+}
+
 SCENARIO("Match any (.) character")
 {
     SECTION("Any character .")
@@ -1803,6 +1861,73 @@ SCENARIO("Match quantifiers")
         REQUIRE(!regex.match("1"));
         REQUIRE(!regex.match("!"));
     }
+
+    SECTION("Ranged quantifier: large upper bound")
+    {
+        auto regex = Regex("[a-z]{1,4096}");
+
+        // Positive test case(s)
+        REQUIRE(regex.match("a"));
+        REQUIRE(regex.match(std::string(4096, 'z')));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(""));
+        REQUIRE(!regex.match(std::string(4097, 'z')));
+    }
+
+    SECTION("Ranged quantifier: nested large bounds")
+    {
+        auto regex = Regex("(ab{2,3}){100}");
+
+        std::string target;
+        for (auto i = 0; i < 100; ++i)
+        {
+            target += (i % 2 == 0) ? "abb" : "abbb";
+        }
+
+        // Positive test case(s)
+        REQUIRE(regex.match(target));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(target + "abb"));
+        REQUIRE(!regex.match(target.substr(3)));
+    }
+
+    SECTION("Ranged quantifier: expansion beyond the size limit throws")
+    {
+        REQUIRE_THROWS_WITH(Regex("(a{1024}){1025}"),
+                            Contains("exceeds the limit"));
+        REQUIRE_THROWS_WITH(Regex("a{4294967295}"),
+                            Contains("exceeds the limit"));
+    }
+
+    SECTION("Ranged quantifier: repetitions of nothing")
+    {
+        auto regex = Regex("(){4000000000}");
+
+        // Positive test case(s)
+        REQUIRE(regex.match(""));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match("a"));
+    }
+
+    SECTION("Nested quantifiers with cycles of empty transitions")
+    {
+        auto regex = Regex("((a*|b?)*c?)*d");
+
+        // Positive test case(s)
+        REQUIRE(regex.match("d"));
+        REQUIRE(regex.match("ad"));
+        REQUIRE(regex.match("bd"));
+        REQUIRE(regex.match("cd"));
+        REQUIRE(regex.match("abcabccbad"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(""));
+        REQUIRE(!regex.match("abc"));
+        REQUIRE(!regex.match("dd"));
+    }
 }
 
 SCENARIO("Match concatenation")
@@ -2119,6 +2244,364 @@ SCENARIO("Match alternation")
     }
 }
 
+SCENARIO("Match utf-16 and utf-32 encoded targets")
+{
+    SECTION("Basic multilingual plane")
+    {
+        auto regex = Regex("[AÅÃ]ሴ+");
+
+        // Positive test case(s)
+        REQUIRE(regex.match(u"Åሴ"));
+        REQUIRE(regex.match(U"Åሴ"));
+        REQUIRE(regex.match(u"Aሴሴሴ"));
+        REQUIRE(regex.match(U"Aሴሴሴ"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(u""));
+        REQUIRE(!regex.match(U""));
+        REQUIRE(!regex.match(u"Bሴ"));
+        REQUIRE(!regex.match(U"Bሴ"));
+    }
+
+    SECTION("Supplementary planes use surrogate pairs in utf-16")
+    {
+        auto regex = Regex("\\U0001F600.\\U00012345");
+
+        // Positive test case(s)
+        REQUIRE(regex.match(u"\U0001F600a\U00012345"));
+        REQUIRE(regex.match(U"\U0001F600a\U00012345"));
+        REQUIRE(regex.match(u"\U0001F600\U0010FFFF\U00012345"));
+        REQUIRE(regex.match(U"\U0001F600\U0010FFFF\U00012345"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(u"\U0001F600\U00012345"));
+        REQUIRE(!regex.match(U"\U0001F600\U00012345"));
+        REQUIRE(!regex.match(u"\U0001F601a\U00012345"));
+        REQUIRE(!regex.match(U"\U0001F601a\U00012345"));
+    }
+
+    SECTION("Unpaired surrogates are code points of their own")
+    {
+        auto regex = Regex("ab[\\uD800-\\uDFFF]*");
+        const auto trailing = std::u16string(u"ab") + char16_t{ 0xD800 };
+        const auto lowFirst = std::u16string(u"ab") + char16_t{ 0xDC00 } +
+                              char16_t{ 0xD800 };
+        const auto unpaired = std::u16string(u"ab") + char16_t{ 0xD800 } +
+                              u"c";
+
+        // Positive test case(s)
+        REQUIRE(regex.match(trailing));
+        REQUIRE(regex.match(lowFirst));
+        REQUIRE(regex.search(unpaired));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(unpaired));
+        REQUIRE(!regex.match(u"ab\U0001F600"));
+        REQUIRE(!Regex("ab").match(trailing));
+    }
+
+    SECTION("Code points beyond the byte range never match in byte mode")
+    {
+        auto regex = Regex(".*", Mode::eBytes);
+
+        // Positive test case(s)
+        REQUIRE(regex.match(u"ÿ"));
+        REQUIRE(regex.match(U"ÿ"));
+
+        // Negative test case(s)
+        REQUIRE(!regex.match(u"Ā"));
+        REQUIRE(!regex.match(U"Ā"));
+    }
+}
+
+SCENARIO("Match with every kind of transition table")
+{
+    SECTION("Offsets fit into 8 bits")
+    {
+        auto regex = Regex("ab");
+        REQUIRE(regex.match("ab"));
+        REQUIRE(!regex.match("abb"));
+    }
+
+    SECTION("Offsets fit into 16 bits")
+    {
+        auto regex = Regex("(a|b)*a(a|b){5}");
+        REQUIRE(regex.match("abbbbb"));
+        REQUIRE(regex.match("bbabbaab"));
+        REQUIRE(!regex.match("bbbbbb"));
+        REQUIRE(!regex.match("abbbbbb"));
+    }
+
+    SECTION("Offsets fit into 32 bits")
+    {
+        auto regex = Regex("(a|b)*a(a|b){14}");
+        REQUIRE(regex.match("abbbbbbbbbbbbbb"));
+        REQUIRE(regex.match("babbbbbbbbbbbbbb"));
+        REQUIRE(!regex.match("bbbbbbbbbbbbbbb"));
+        REQUIRE(!regex.match("abbbbbbbbbbbbbbb"));
+    }
+
+    SECTION("Sparse rows are packed into a comb")
+    {
+        // 300 distinct code points each need their own input and state, too
+        // many inputs for 8 bits. Every state has one transition that does
+        // not lead to the dead state.
+        std::u32string literal;
+        for (char32_t c = 0x100; c < 0x100 + 300; ++c)
+        {
+            literal += c;
+        }
+
+        std::stringstream pattern;
+        pattern << std::hex << std::setfill('0');
+        for (const auto c : literal)
+        {
+            pattern << "\\u" << std::setw(4) << static_cast<uint32_t>(c);
+        }
+
+        auto regex = Regex(pattern.str());
+        REQUIRE(regex.match(literal));
+        REQUIRE(!regex.match(literal.substr(1)));
+        REQUIRE(!regex.match(literal + literal));
+    }
+}
+
+SCENARIO("Profile and optimize the automaton")
+{
+    auto regex = Regex("(a|b)*c");
+    const auto samples = std::vector<std::string>{ "aab", "abc", "x" };
+
+    SECTION("Every state visited while matching is counted")
+    {
+        // The dead state, the loop and the final state
+        const auto visits = regex.profile(samples);
+        REQUIRE(visits.size() == 3);
+        CHECK(visits[0] == 1);
+        CHECK(visits[0] + visits[1] + visits[2] == 10);
+    }
+
+    SECTION("The most visited states come after the sinks")
+    {
+        regex.optimize(samples);
+        const auto visits = regex.profile(samples);
+        CHECK(visits[1] >= visits[2]);
+
+        REQUIRE(regex.match("ababc"));
+        REQUIRE(regex.match("c"));
+        REQUIRE(!regex.match("abca"));
+        REQUIRE(!regex.match(""));
+    }
+}
+
+SCENARIO("Skip through states left on few bytes")
+{
+    // Long runs take the block scan, short ones only the tail
+    const auto run = std::string(100, 'x');
+
+    SECTION("A quoted string")
+    {
+        for (const auto mode : { Mode::eUtf8, Mode::eBytes })
+        {
+            auto regex = Regex("\"[^\"\\\\]*(\\\\.[^\"\\\\]*)*\"", mode);
+            REQUIRE(regex.match("\"" + run + "\""));
+            REQUIRE(regex.match("\"x\\\"" + run + "\""));
+            REQUIRE(regex.match("\"\""));
+            REQUIRE(!regex.match("\"" + run));
+            REQUIRE(!regex.match("\"" + run + "\"x"));
+            REQUIRE(!regex.match("\"" + run + "\\\""));
+        }
+    }
+
+    SECTION("Anything up to a literal")
+    {
+        auto regex = Regex(".*foo");
+        REQUIRE(regex.match(run + "foo"));
+        REQUIRE(regex.match(run + "ffoo" + run + "fofoo"));
+        REQUIRE(!regex.match(run + "fo"));
+        REQUIRE(!regex.match(run + "\nfoo"));
+        REQUIRE(!regex.match(run + "foo\n"));
+    }
+
+    SECTION("Multibyte characters are skipped in UTF-8")
+    {
+        auto regex = Regex("[^;]*;é");
+        REQUIRE(regex.match("é世" + run + "😀;é"));
+        REQUIRE(!regex.match("é世" + run + ";ê"));
+        REQUIRE(regex.match(U"世;é"));
+    }
+
+    SECTION("Any byte but a few in byte mode")
+    {
+        auto regex = Regex("[^\\x00\\xff]*\\xff", Mode::eBytes);
+        REQUIRE(regex.match(run + "\x80\xfe\xff"));
+        REQUIRE(!regex.match(run + std::string(1, '\0') + "\xff"));
+        REQUIRE(!regex.match(run));
+    }
+
+    SECTION("Accelerated states survive optimize")
+    {
+        auto regex = Regex("a[^b]*b|c");
+        regex.optimize({ "a" + run + "b", "c", "axb" });
+        REQUIRE(regex.match("a" + run + "b"));
+        REQUIRE(regex.match("c"));
+        REQUIRE(!regex.match("a" + run));
+        REQUIRE(!regex.match("a" + run + "bb"));
+    }
+}
+
+SCENARIO("Match plain literals without an automaton")
+{
+    SECTION("Literal with escaped metacharacters")
+    {
+        auto regex = Regex("a\\.b\\*\\(c\\)");
+        REQUIRE(regex.match("a.b*(c)"));
+        REQUIRE(!regex.match("axb*(c)"));
+        REQUIRE(!regex.match("a.b*(c)d"));
+        REQUIRE(!regex.match(""));
+        REQUIRE(regex.search("xx a.b*(c) xx"));
+        REQUIRE(!regex.search("xx a.b*(c xx"));
+    }
+
+    SECTION("Literal beyond the basic multilingual plane")
+    {
+        auto regex = Regex("é\U0001F600世");
+        REQUIRE(regex.match("é\U0001F600世"));
+        REQUIRE(regex.match(u"é\U0001F600世"));
+        REQUIRE(regex.match(U"é\U0001F600世"));
+        REQUIRE(!regex.match(U"é\U0001F601世"));
+        REQUIRE(regex.search("xé\U0001F600世x"));
+        REQUIRE(regex.search(u"xé\U0001F600世x"));
+        REQUIRE(regex.search(U"xé\U0001F600世x"));
+        REQUIRE(!regex.search(u"xé\U0001F600x"));
+    }
+
+    SECTION("Literal in byte mode")
+    {
+        auto regex = Regex("\\xffa\\x00", Mode::eBytes);
+        REQUIRE(regex.match(std::string("\xff" "a", 3)));
+        REQUIRE(!regex.match(std::string("\xc3\xbf" "a", 4)));
+        REQUIRE(regex.match(std::u32string(U"\u00ffa\0", 3)));
+        REQUIRE(regex.search(std::string("b\xff" "a\x00" "b", 5)));
+        REQUIRE(!regex.search(std::u32string(U"\u00ffa\0\u4e16", 4)));
+    }
+
+    SECTION("The empty pattern")
+    {
+        auto regex = Regex("");
+        REQUIRE(regex.match(""));
+        REQUIRE(!regex.match("a"));
+        REQUIRE(regex.search("a"));
+    }
+
+    SECTION("The automaton is built for profiling")
+    {
+        auto regex = Regex("abc");
+        REQUIRE(regex.profile({ "abc" }).size() > 1);
+        regex.optimize({ "abc" });
+        REQUIRE(regex.match("abc"));
+    }
+}
+
+SCENARIO("Match one class repeated")
+{
+    const auto word = std::string(50, 'w');
+
+    SECTION("ASCII targets")
+    {
+        auto regex = Regex("[A-Za-z0-9_-]{1,64}");
+        REQUIRE(regex.match(word));
+        REQUIRE(regex.match("user-name_01"));
+        REQUIRE(!regex.match(word + word));
+        REQUIRE(!regex.match("user name"));
+        REQUIRE(!regex.match(""));
+    }
+
+    SECTION("Targets beyond ASCII fall back to the automaton")
+    {
+        auto regex = Regex("[^\\s]{1,51}");
+        REQUIRE(regex.match(word + "é"));
+        REQUIRE(!regex.match(word + "éé"));
+        REQUIRE(!regex.match(word + " é"));
+    }
+
+    SECTION("Bytes beyond ASCII in byte mode")
+    {
+        auto regex = Regex("[a-z\\xff]+", Mode::eBytes);
+        REQUIRE(regex.match(word + "\xff"));
+        REQUIRE(!regex.match(word + "\xfe"));
+    }
+}
+
+SCENARIO("Search targets")
+{
+    SECTION("Literal")
+    {
+        auto regex = Regex("ERROR");
+        REQUIRE(regex.search("ERROR"));
+        REQUIRE(regex.search("2024-01-01 ERROR disk full"));
+        REQUIRE(!regex.search("2024-01-01 WARN disk full"));
+        REQUIRE(!regex.search(""));
+    }
+
+    SECTION("Literal surrounded by repetitions")
+    {
+        auto regex = Regex("user_id=[0-9]+ ");
+        REQUIRE(regex.search("GET / user_id=42 200"));
+        REQUIRE(!regex.search("GET / user_id= 200"));
+        REQUIRE(!regex.search("GET / user_id=42"));
+    }
+
+    SECTION("One of a set of literals")
+    {
+        auto regex = Regex("(FATAL|PANIC|ERROR|CRITICAL): [a-z]+");
+        REQUIRE(regex.search("2024-01-01 12:00:00 CRITICAL: disk full"));
+        REQUIRE(regex.search("2024-01-01 12:00:00 PANIC: oom"));
+        REQUIRE(!regex.search("2024-01-01 12:00:00 INFO: served"));
+        REQUIRE(!regex.search("2024-01-01 12:00:00 ERROR: 42"));
+    }
+
+    SECTION("Matches start a bounded distance before the required literal")
+    {
+        auto regex = Regex("[0-9]{1,3} ERROR");
+        REQUIRE(regex.search("x ERROR ab WARN 12 ERROR"));
+        REQUIRE(regex.search("1 ERROR"));
+        REQUIRE(!regex.search("x ERROR 1234 WARN a ERROR"));
+
+        // the start backs up to the lead byte of a character
+        auto unicode = Regex("(é|世){1,2}abc");
+        REQUIRE(unicode.search("abc xabc 世éabc"));
+        REQUIRE(unicode.search("世abc"));
+        REQUIRE(!unicode.search("abc xabc xxabc"));
+
+        auto bytes = Regex("[\\x80-\\xff]{2}abc", Mode::eBytes);
+        REQUIRE(bytes.search(std::string("abc\xff" "abc\x80\xff" "abc")));
+        REQUIRE(!bytes.search(std::string("abc\xff" "abc\xff" "abc")));
+    }
+
+    SECTION("Pattern matching the empty string is found everywhere")
+    {
+        auto regex = Regex("a*");
+        REQUIRE(regex.search(""));
+        REQUIRE(regex.search("bbb"));
+    }
+
+    SECTION("Utf-16 and utf-32 targets")
+    {
+        auto regex = Regex("Ж+");
+        REQUIRE(regex.search(u"abЖЖc"));
+        REQUIRE(regex.search(U"abЖc"));
+        REQUIRE(!regex.search(u"abc"));
+        REQUIRE(!regex.search(U"abc"));
+    }
+
+    SECTION("Byte mode")
+    {
+        auto regex = Regex("\\xff\\x00", Mode::eBytes);
+        REQUIRE(regex.search(std::string("ab\xff\x00" "cd", 6)));
+        REQUIRE(!regex.search(std::string("ab\xff\x01" "cd", 6)));
+    }
+}
+
 SCENARIO("Random tests")
 {
     SECTION("Realistic tests using dates")
@@ -2131,6 +2614,30 @@ SCENARIO("Random tests")
         REQUIRE(regex.match("12-OCT-2022"));
     }
 
+    SECTION("Fourth letter from the end is an 'a'")
+    {
+        auto regex = Regex("(a|b)*a(a|b){3}");
+        REQUIRE(regex.match("abbb"));
+        REQUIRE(regex.match("babab"));
+        REQUIRE(regex.match("bbbbbbaaaa"));
+        REQUIRE(!regex.match("bbbb"));
+        REQUIRE(!regex.match("aaabbba"));
+        REQUIRE(!regex.match("aab"));
+    }
+
+    SECTION("Classes the minimized DFA does not distinguish")
+    {
+        // a-l, m-n and o-z are separate classes until minimization
+        auto regex = Regex("[a-z]+|[m-n]+|\u0100");
+        REQUIRE(regex.match("amz"));
+        REQUIRE(regex.match("nnn"));
+        REQUIRE(regex.match(U"\u0100"));
+        REQUIRE(!regex.match(""));
+        REQUIRE(!regex.match("aMz"));
+        REQUIRE(!regex.match(U"a\u0100"));
+        REQUIRE(!regex.match(U"\u0101"));
+    }
+
     SECTION("Hello World! in Kanji:「こんにちは世界」")
     {
         const std::array kanji = { '\xE3', '\x80', '\x8C', '\xE3', '\x81',
@@ -0,0 +1,102 @@
+#include "Parser.hpp"
+#include "Simplifier.hpp"
+#include <catch2/catch.hpp>
+
+namespace regex::ast
+{
+namespace
+{
+
+std::string simplified(const std::string& regex)
+{
+    return simplify(parser::Parser(regex).parse()).print();
+}
+
+SCENARIO("Simplify the AST")
+{
+    SECTION("Nested concatenations are flattened")
+    {
+        CHECK(simplified("(a)(bc)") ==
+              "([\\U00000061-\\U00000061][\\U00000062-\\U00000062]["
+              "\\U00000063-\\U00000063])");
+    }
+
+    SECTION("Empty groups are dropped from concatenations")
+    {
+        CHECK(simplified("a()b") ==
+              "([\\U00000061-\\U00000061][\\U00000062-\\U00000062])");
+    }
+
+    SECTION("A concatenation with a class matching nothing matches nothing")
+    {
+        CHECK(simplified("a[^\\x00-\\U0010ffff]b").empty());
+    }
+
+    SECTION("Classes of an alternation are merged")
+    {
+        CHECK(simplified("a|b|[c-e]") == "[\\U00000061-\\U00000065]");
+    }
+
+    SECTION("Duplicate alternatives are removed")
+    {
+        CHECK(simplified("ab|ab") ==
+              "([\\U00000061-\\U00000061][\\U00000062-\\U00000062])");
+    }
+
+    SECTION("Common prefixes of alternatives are factored")
+    {
+        CHECK(simplified("foo1|foo2|foo3") ==
+              "([\\U00000066-\\U00000066][\\U0000006f-\\U0000006f]["
+              "\\U0000006f-\\U0000006f][\\U00000031-\\U00000033])");
+    }
+
+    SECTION("Common prefixes of alternatives are factored into a trie")
+    {
+        CHECK(simplified("a|ab|abc") ==
+              "([\\U00000061-\\U00000061](|([\\U00000062-\\U00000062](["
+              "\\U00000063-\\U00000063]|))))");
+    }
+
+    SECTION("Common suffixes of alternatives are factored")
+    {
+        CHECK(simplified("xa|ya|za") ==
+              "([\\U00000078-\\U0000007a][\\U00000061-\\U00000061])");
+    }
+
+    SECTION("Common prefixes and suffixes of alternatives are factored")
+    {
+        CHECK(simplified("ab|cb|ad|cd") ==
+              "([\\U00000061-\\U00000061\\U00000063-\\U00000063]["
+              "\\U00000062-\\U00000062\\U00000064-\\U00000064])");
+    }
+
+    SECTION("Repeating exactly once is folded")
+    {
+        CHECK(simplified("a{1}") == "[\\U00000061-\\U00000061]");
+    }
+
+    SECTION("Repeating zero times is folded")
+    {
+        CHECK(simplified("ab{0,0}") == "[\\U00000061-\\U00000061]");
+    }
+
+    SECTION("Nested unbounded repetitions are folded")
+    {
+        CHECK(simplified("((a?)+)*") == "[\\U00000061-\\U00000061]{0,}");
+    }
+
+    SECTION("Adjacent repetitions of the same expression are merged")
+    {
+        CHECK(simplified("aa*") == "[\\U00000061-\\U00000061]{1,}");
+        CHECK(simplified("a*a{2,3}") == "[\\U00000061-\\U00000061]{2,}");
+    }
+
+    SECTION("Adjacent bounded repetitions are kept")
+    {
+        CHECK(simplified("aa") ==
+              "([\\U00000061-\\U00000061][\\U00000061-\\U00000061])");
+    }
+}
+
+} // namespace
+} // namespace regex::ast
@@ -0,0 +1,79 @@
+#include "Teddy.hpp"
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace regex
+{
+namespace
+{
+
+SCENARIO("Find any of a set of literals")
+{
+    const auto teddy = Teddy({ "FATAL", "ERROR", "WARN", "PANIC" });
+
+    SECTION("Literals anywhere in the haystack")
+    {
+        CHECK(teddy.find("ERROR") == 0);
+        CHECK(teddy.find("xWARN") == 1);
+        CHECK(teddy.find("INFO request served") == std::string::npos);
+        CHECK(teddy.find("") == std::string::npos);
+    }
+
+    SECTION("The first occurrence of any literal")
+    {
+        CHECK(teddy.find("-PANIC-ERROR-") == 1);
+        CHECK(teddy.find("-ERROR-PANIC-") == 1);
+    }
+
+    SECTION("Literals across the end of blocks of 16 bytes")
+    {
+        const auto padding = std::string(40, '-');
+        for (std::size_t i = 0; i <= padding.size(); ++i)
+        {
+            const auto haystack = padding.substr(0, i) + "FATAL" +
+                                  padding.substr(i);
+            CHECK(teddy.find(haystack) == i);
+            CHECK(teddy.find(haystack.substr(0, i + 4)) ==
+                  std::string::npos);
+        }
+    }
+
+    SECTION("Fingerprints that match without a literal")
+    {
+        CHECK(teddy.find("FATEL ERRAR WARD PANIK") == std::string::npos);
+        CHECK(teddy.find(std::string(64, 'E') + "ERROR") == 64);
+    }
+}
+
+SCENARIO("Find literals of other shapes")
+{
+    SECTION("More literals than buckets")
+    {
+        const auto teddy = Teddy(
+          { "GET", "POST", "PUT", "DELETE", "HEAD", "OPTIONS", "PATCH",
+            "TRACE", "CONNECT", "LINK", "UNLINK" });
+        CHECK(teddy.find(std::string(30, ' ') + "UNLINK") == 30);
+        CHECK(teddy.find(std::string(30, ' ') + "LINK") == 30);
+        CHECK(teddy.find(std::string(30, ' ') + "TRACK") ==
+              std::string::npos);
+    }
+
+    SECTION("Literals shorter than the fingerprint")
+    {
+        const auto teddy = Teddy({ "a", "bc" });
+        CHECK(teddy.find(std::string(20, 'x') + "b" + "a") == 21);
+        CHECK(teddy.find(std::string(20, 'x') + "bc") == 20);
+    }
+
+    SECTION("Bytes outside of ASCII")
+    {
+        const auto teddy = Teddy({ "Ж", "\xFF\x80" });
+        CHECK(teddy.find(std::string(20, 'x') + "Ж") == 20);
+        CHECK(teddy.find(std::string(20, 'x') + "\xFF\x80") == 20);
+        CHECK(teddy.find(std::string(20, '\xFF')) == std::string::npos);
+    }
+}
+
+} // namespace
+} // namespace regex